@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <charconv>
 #include <cstdlib>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 
 #include <drogon/drogon.h>
 
@@ -10,41 +17,75 @@
 
 namespace {
 
-std::filesystem::path ResolveProductsRoot(int argc, char** argv) {
-  std::filesystem::path defaultRoot = "_kano/backlog/products";
-
-  if (const char* envRoot = std::getenv("KANO_BACKLOG_PRODUCTS_ROOT"); envRoot != nullptr) {
-    if (std::strlen(envRoot) > 0) {
-      defaultRoot = envRoot;
-    }
-  }
-
+// Value following flag on the command line, else the env variable; null
+// when neither is set (an empty variable counts as unset).
+const char* OptionValue(int argc, char** argv, const std::string_view flag, const char* env) {
   for (int i = 1; i < argc; ++i) {
-    const std::string arg = argv[i];
-    if (arg == "--backlog-root" && (i + 1) < argc) {
+    if (argv[i] == flag) {
+      if (i + 1 == argc) {
+        throw std::invalid_argument(std::string(flag) + " needs a value");
+      }
       return argv[i + 1];
     }
   }
+  const char* value = std::getenv(env);
+  return value != nullptr && *value != '\0' ? value : nullptr;
+}
 
-  return defaultRoot;
+std::filesystem::path ResolveProductsRoot(int argc, char** argv) {
+  const char* root = OptionValue(argc, argv, "--backlog-root", "KANO_BACKLOG_PRODUCTS_ROOT");
+  return root != nullptr ? root : "_kano/backlog/products";
 }
 
-uint16_t ResolvePort(int argc, char** argv) {
-  uint16_t port = 8787;
-  for (int i = 1; i < argc; ++i) {
-    const std::string arg = argv[i];
-    if (arg == "--port" && (i + 1) < argc) {
-      port = static_cast<uint16_t>(std::stoi(argv[i + 1]));
-      return port;
-    }
+// Decimal count from flag or env, or fallback; anything else is rejected.
+size_t SizeOption(int argc, char** argv, const std::string_view flag, const char* env,
+                  const size_t fallback) {
+  const char* text = OptionValue(argc, argv, flag, env);
+  if (text == nullptr) {
+    return fallback;
+  }
+  size_t value = 0;
+  const auto* end = text + std::strlen(text);
+  const auto [ptr, ec] = std::from_chars(text, end, value);
+  if (ec != std::errc() || ptr != end) {
+    throw std::invalid_argument("invalid value for " + std::string(flag) + " / " + env + ": '" +
+                                text + "'");
+  }
+  return value;
+}
+
+// SizeOption in MiB, returned in bytes; fallbackBytes is passed through.
+size_t MebibyteOption(int argc, char** argv, const std::string_view flag, const char* env,
+                      const size_t fallbackBytes) {
+  constexpr size_t kMiB = 1024 * 1024;
+  const auto megabytes = SizeOption(argc, argv, flag, env, fallbackBytes / kMiB);
+  if (megabytes > std::numeric_limits<size_t>::max() / kMiB) {
+    throw std::invalid_argument(std::string(flag) + " is too large");
   }
+  return megabytes * kMiB;
+}
 
-  if (const char* envPort = std::getenv("KANO_WEBVIEW_PORT"); envPort != nullptr) {
-    if (std::strlen(envPort) > 0) {
-      port = static_cast<uint16_t>(std::stoi(envPort));
+// flag alone (it takes no value) turns fallback around. env takes
+// 1/true/on or 0/false/off.
+bool BoolOption(int argc, char** argv, const std::string_view flag, const char* env,
+                const bool fallback) {
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i] == flag) {
+      return !fallback;
     }
   }
-  return port;
+  const char* text = std::getenv(env);
+  if (text == nullptr || *text == '\0') {
+    return fallback;
+  }
+  const std::string_view value = text;
+  if (value == "1" || value == "true" || value == "on") {
+    return true;
+  }
+  if (value == "0" || value == "false" || value == "off") {
+    return false;
+  }
+  throw std::invalid_argument("invalid value for " + std::string(env) + ": '" + text + "'");
 }
 
 const char* kIndexHtml = R"HTML(
@@ -75,13 +116,15 @@ const char* kIndexHtml = R"HTML(
     .kanban { display: grid; grid-template-columns: repeat(5, minmax(180px, 1fr)); gap: 10px; }
     .lane { background: #fff; border: 1px solid #dde3f0; border-radius: 10px; padding: 8px; min-height: 140px; }
     .card { border: 1px solid #cfd9ea; border-radius: 8px; padding: 8px; margin-bottom: 8px; background: #fcfdff; }
-    .tree ul { list-style: none; padding-left: 18px; margin: 0; }
-    .tree li { margin: 2px 0; }
-    .tree details { margin: 2px 0; }
-    .tree summary { cursor: pointer; }
-    .tree summary::marker { color: #5a6d8f; }
+    .vbox { position: relative; overflow-y: auto; }
+    .vspacer { position: relative; }
+    .vrow { position: absolute; left: 0; right: 0; height: 26px; line-height: 26px; white-space: nowrap; overflow: hidden; text-overflow: ellipsis; box-sizing: border-box; }
+    .tree-box { height: 70vh; }
     .tree .node-line { display: inline-flex; gap: 6px; align-items: center; }
-    .tree .leaf-spacer { display: inline-block; width: 12px; }
+    .tree .leaf-spacer { display: inline-block; width: 18px; }
+    .tree-toggle { width: 18px; padding: 0; border: 0; background: none; color: #5a6d8f; cursor: pointer; }
+    .lane-box { height: 65vh; margin-top: 6px; }
+    .vcard { position: absolute; left: 0; right: 4px; height: 70px; margin: 0; overflow: hidden; box-sizing: border-box; }
     .btn { border: 1px solid #cfd9ea; background: #fff; border-radius: 6px; padding: 4px 10px; cursor: pointer; }
     .btn:hover { background: #f2f6ff; }
     .filters { display: flex; gap: 10px; flex-wrap: wrap; margin: 8px 0 10px 0; }
@@ -147,7 +190,7 @@ const char* kIndexHtml = R"HTML(
         <button id="expand-all" class="btn">Expand All</button>
         <button id="collapse-all" class="btn">Collapse All</button>
       </div>
-      <div id="tree"></div>
+      <div id="tree" class="vbox tree-box"><div class="vspacer"></div></div>
   </div>
 
   <div id="page-kanban" class="panel page">
@@ -182,7 +225,13 @@ const char* kIndexHtml = R"HTML(
 )HTML"
 R"HTML(  <script src="https://cdn.jsdelivr.net/npm/marked/marked.min.js"></script>
   <script src="https://cdn.jsdelivr.net/npm/highlight.js@11.9.0/lib/highlight.min.js"></script>
-  <script>
+  <script src="@APP_SCRIPT_URL@"></script>
+</body>
+</html>
+)HTML";
+
+// Served from a content-hashed URL, so browsers cache it until the UI changes.
+const char* kIndexScript = R"JS(
     const state = {
       product: '',
       q: '',
@@ -190,16 +239,84 @@ R"HTML(  <script src="https://cdn.jsdelivr.net/npm/marked/marked.min.js"></scrip
       workspaces: [],
       treeOpen: new Set(),
       treeTouched: false,
+      // Expand All: every node is open except those in treeClosed.
+      treeExpandAll: false,
+      treeClosed: new Set(),
       activeTab: 'tree',
       kanbanTypes: new Set(['Epic', 'Feature', 'UserStory', 'Task']),
-      allItems: []
+      // Snapshot generation the views were last loaded from, per /api/events.
+      generation: null,
+      openItemId: null
     };
     const lanes = ['Backlog', 'Doing', 'Blocked', 'Review', 'Done'];
+    // Members the cards render; the server filters and projects the rest away.
+    const cardFields = 'title,type,state,source_kind';
     const workspaceStorageKey = 'kano_webview_workspaces_v2';
 
+    // Conditional GETs: the server tags view payloads with a strong ETag and
+    // answers a matching If-None-Match with an empty 304.
+    const etagCache = new Map();
+    const etagCacheLimit = 64;
+
     async function getJson(url) {
-      const resp = await fetch(url);
-      return resp.json();
+      const cached = etagCache.get(url);
+      const headers = cached ? { 'If-None-Match': cached.etag } : {};
+      const resp = await fetch(url, { headers });
+      if (resp.status === 304 && cached) {
+        etagCache.delete(url);
+        etagCache.set(url, cached);
+        return cached.body;
+      }
+      const body = await resp.json();
+      const etag = resp.headers.get('ETag');
+      etagCache.delete(url);
+      if (etag) {
+        etagCache.set(url, { etag, body });
+        if (etagCache.size > etagCacheLimit) {
+          etagCache.delete(etagCache.keys().next().value);
+        }
+      }
+      return body;
+    }
+
+    // Items the modal can show without a request. Wikilink targets of the
+    // open item are prefetched in one /api/items/batch call; entries are
+    // dropped when their ids change, and the epoch discards prefetches that
+    // were in flight at the time.
+    const itemCache = new Map();
+    const itemCacheLimit = 256;
+    const itemPrefetchLimit = 100;
+    let itemCacheEpoch = 0;
+
+    function rememberItem(item) {
+      itemCache.delete(item.id);
+      itemCache.set(item.id, item);
+      if (itemCache.size > itemCacheLimit) {
+        itemCache.delete(itemCache.keys().next().value);
+      }
+    }
+
+    function forgetItems(ids) {
+      itemCacheEpoch += 1;
+      if (!ids) {
+        itemCache.clear();
+        return;
+      }
+      ids.forEach((id) => itemCache.delete(id));
+    }
+
+    async function prefetchItems(ids) {
+      const wanted = [...new Set(ids)].filter((id) => !itemCache.has(id)).slice(0, itemPrefetchLimit);
+      if (!wanted.length) return;
+      const epoch = itemCacheEpoch;
+      const product = state.product;
+      // POST keeps long id lists out of the URL.
+      const params = new URLSearchParams({ product, ids: wanted.join(','), content: '1' });
+      const resp = await fetch('/api/items/batch', { method: 'POST', body: params });
+      if (!resp.ok) return;
+      const result = await resp.json();
+      if (epoch !== itemCacheEpoch || product !== state.product) return;
+      (result?.data?.items || []).forEach(rememberItem);
     }
 
     function nowIso() {
@@ -379,6 +496,8 @@ R"HTML(  <script src="https://cdn.jsdelivr.net/npm/marked/marked.min.js"></scrip
       if (!clean) {
         return;
       }
+      // Answered once the new workspace is loaded; the old one stays usable.
+      document.getElementById('status').textContent = 'Loading workspace...';
       const result = await getJson(`/api/workspace/switch?path=${encodeURIComponent(clean)}`);
       if (!result?.ok) {
         document.getElementById('status').textContent =
@@ -396,7 +515,10 @@ R"HTML(  <script src="https://cdn.jsdelivr.net/npm/marked/marked.min.js"></scrip
 
       state.treeOpen.clear();
       state.treeTouched = false;
+      state.treeExpandAll = false;
+      state.treeClosed.clear();
       await loadProducts();
+      watchChanges();
       await refreshAll();
     }
 
@@ -452,8 +574,8 @@ R"HTML(  <script src="https://cdn.jsdelivr.net/npm/marked/marked.min.js"></scrip
       return `<pre>${esc(text)}</pre>`;
     }
 
-)HTML"
-R"HTML(    function typeIcon(type) {
+)JS"
+R"JS(    function typeIcon(type) {
       const map = {
         Theme: '🧩',
         Epic: '👑',
@@ -465,41 +587,6 @@ R"HTML(    function typeIcon(type) {
       return map[type] || '•';
     }
 
-    function renderTreeNode(node, depth = 0) {
-      const children = node.children || [];
-      const label = `<span class="node-line"><span>${typeIcon(node.type)}</span><code>${esc(node.id)}</code><a href="#" class="item-link" data-item-id="${escAttr(node.id)}">${esc(node.title)}</a><span class="muted">(${esc(node.type)} / ${esc(node.state)})</span></span>`;
-      if (!children.length) {
-        return `<li><span class="leaf-spacer"></span>${label}</li>`;
-      }
-      const isOpen = state.treeOpen.has(node.id) || depth <= 1 ? 'open' : '';
-      return `<li><details data-node-id="${escAttr(node.id)}" ${isOpen}><summary>${label}</summary><ul>${children.map((child) => renderTreeNode(child, depth + 1)).join('')}</ul></details></li>`;
-    }
-
-    function bindTreeToggles() {
-      document.querySelectorAll('#tree details[data-node-id]').forEach((detail) => {
-        detail.addEventListener('toggle', () => {
-          const id = detail.getAttribute('data-node-id');
-          if (!id) return;
-          state.treeTouched = true;
-          if (detail.open) {
-            state.treeOpen.add(id);
-          } else {
-            state.treeOpen.delete(id);
-          }
-        });
-      });
-
-      document.querySelectorAll('#tree .item-link[data-item-id]').forEach((link) => {
-        link.addEventListener('click', async (event) => {
-          event.preventDefault();
-          event.stopPropagation();
-          const id = link.getAttribute('data-item-id');
-          if (!id) return;
-          await openItemModal(id);
-        });
-      });
-    }
-
     function openModal(title, bodyHtml) {
       document.getElementById('item-modal-title').textContent = title;
       document.getElementById('item-modal-body').innerHTML = bodyHtml;
@@ -507,12 +594,17 @@ R"HTML(    function typeIcon(type) {
     }
 
     function closeModal() {
+      state.openItemId = null;
       document.getElementById('item-modal-backdrop').classList.remove('open');
     }
 
     async function openItemModal(itemId) {
-      const data = await getJson(`/api/items/${encodeURIComponent(itemId)}?product=${encodeURIComponent(state.product)}`);
-      const item = data?.data?.item;
+      state.openItemId = itemId;
+      let item = itemCache.get(itemId);
+      if (!item) {
+        const data = await getJson(`/api/items/${encodeURIComponent(itemId)}?product=${encodeURIComponent(state.product)}`);
+        item = data?.data?.item;
+      }
       if (!item) {
         openModal(itemId, '<div class="muted">Item not found.</div>');
         return;
@@ -521,7 +613,9 @@ R"HTML(    function typeIcon(type) {
       const body = `<div class="row"><code>${esc(item.id)}</code><span class="muted">${esc(item.type)} / ${esc(item.state)} / ${esc(item.source_kind || '')}</span></div><div class="muted" style="margin-bottom:8px;">${esc(item.path || '')}</div><div class="md-view">${contentHtml}</div>`;
       openModal(item.title || item.id, body);
 
+      const linked = [];
       document.querySelectorAll('#item-modal-body .obs-wikilink[data-item-id]').forEach((link) => {
+        linked.push(link.getAttribute('data-item-id'));
         link.addEventListener('click', async (event) => {
           event.preventDefault();
           const target = link.getAttribute('data-item-id');
@@ -529,6 +623,7 @@ R"HTML(    function typeIcon(type) {
           await openItemModal(target);
         });
       });
+      prefetchItems(linked.filter(Boolean)).catch(() => {});
 
       if (window.hljs) {
         document.querySelectorAll('#item-modal-body pre code').forEach((block) => {
@@ -553,50 +648,233 @@ R"HTML(    function typeIcon(type) {
       state.product = select.value || '';
     }
 
+    // Windowed views: the tree and each kanban lane are scroll boxes of
+    // fixed-height rows, and only the rows in view (plus a margin) are in
+    // the DOM. Rows arrive in pages from /api/tree/children and /api/kanban
+    // as they scroll into view, so neither the page nor any response grows
+    // with the backlog.
+    const treeRowHeight = 26;
+    const treePageSize = 200;
+    const cardHeight = 78;
+    const kanbanPageSize = 50;
+    const kanbanPagesKept = 8;
+    const windowOverscan = 6;
+
+    // Row indices [first, last) to render for a box of count rows.
+    function visibleRange(box, rowHeight, count) {
+      const first = Math.max(0, Math.floor(box.scrollTop / rowHeight) - windowOverscan);
+      const last = Math.min(count, Math.ceil((box.scrollTop + box.clientHeight) / rowHeight) + windowOverscan);
+      return [first, last];
+    }
+
+    const pendingFrames = new Map();
+    function scheduleRender(key, render) {
+      if (pendingFrames.has(key)) return;
+      pendingFrames.set(key, requestAnimationFrame(() => {
+        pendingFrames.delete(key);
+        render();
+      }));
+    }
+
+    // The loaded part of the tree: child ids fetched so far per parent ('' is
+    // the roots) and how many there are, nodes by id, and the open part
+    // flattened into rows.
+    const tree = { nodes: new Map(), children: new Map(), loading: new Set(), rows: [], epoch: 0 };
+
+    function isTreeOpen(id) {
+      return state.treeExpandAll ? !state.treeClosed.has(id) : state.treeOpen.has(id);
+    }
+
+    async function fetchTreePage(parent, offset) {
+      const result = await getJson(`/api/tree/children?product=${encodeURIComponent(state.product)}&id=${encodeURIComponent(parent)}&depth=1&offset=${offset}&limit=${treePageSize}`);
+      return result?.data || {};
+    }
+
+    function storeTreePage(parent, data) {
+      const entry = tree.children.get(parent) || { ids: [], total: 0 };
+      for (const node of (data.nodes || [])) {
+        tree.nodes.set(node.id, node);
+        entry.ids.push(node.id);
+      }
+      entry.total = data.total ?? entry.ids.length;
+      tree.children.set(parent, entry);
+    }
+
+    async function loadTreePage(parent) {
+      const entry = tree.children.get(parent);
+      if (tree.loading.has(parent) || (entry && entry.ids.length >= entry.total)) return;
+      const epoch = tree.epoch;
+      tree.loading.add(parent);
+      const data = await fetchTreePage(parent, entry ? entry.ids.length : 0).catch(() => ({}));
+      if (epoch !== tree.epoch) return;
+      tree.loading.delete(parent);
+      storeTreePage(parent, data);
+      rebuildTreeRows();
+    }
+
+    // A parent with children still to fetch ends in a placeholder row, which
+    // loads the next page once it is rendered.
+    function rebuildTreeRows() {
+      const rows = [];
+      const walk = (parent, depth) => {
+        const entry = tree.children.get(parent);
+        for (const id of (entry ? entry.ids : [])) {
+          rows.push({ id, depth });
+          if (tree.nodes.get(id).child_count && isTreeOpen(id)) walk(id, depth + 1);
+        }
+        if (!entry || entry.ids.length < entry.total) rows.push({ more: parent, depth });
+      };
+      walk('', 0);
+      tree.rows = rows;
+      renderTreeWindow();
+    }
+
+    function renderTreeWindow() {
+      const box = document.getElementById('tree');
+      const spacer = box.firstElementChild;
+      spacer.style.height = `${tree.rows.length * treeRowHeight}px`;
+      const [first, last] = visibleRange(box, treeRowHeight, tree.rows.length);
+      let html = '';
+      for (let i = first; i < last; i++) {
+        const row = tree.rows[i];
+        const style = `top:${i * treeRowHeight}px;padding-left:${row.depth * 18}px`;
+        if (row.more !== undefined) {
+          html += `<div class="vrow muted" style="${style}"><span class="leaf-spacer"></span>Loading…</div>`;
+          loadTreePage(row.more);
+          continue;
+        }
+        const node = tree.nodes.get(row.id);
+        if (!node) continue;
+        const toggle = node.child_count
+          ? `<button class="tree-toggle" data-toggle-id="${escAttr(node.id)}">${isTreeOpen(node.id) ? '▾' : '▸'}</button>`
+          : '<span class="leaf-spacer"></span>';
+        const count = node.child_count ? ` · ${node.child_count}` : '';
+        html += `<div class="vrow" style="${style}">${toggle}<span class="node-line"><span>${typeIcon(node.type)}</span><code>${esc(node.id)}</code><a href="#" class="item-link" data-item-id="${escAttr(node.id)}">${esc(node.title)}</a><span class="muted">(${esc(node.type)} / ${esc(node.state)}${count})</span></span></div>`;
+      }
+      spacer.innerHTML = html;
+    }
+
+    function toggleTreeNode(id) {
+      state.treeTouched = true;
+      const set = state.treeExpandAll ? state.treeClosed : state.treeOpen;
+      if (set.has(id)) {
+        set.delete(id);
+      } else {
+        set.add(id);
+      }
+      rebuildTreeRows();
+    }
+
     async function loadTree() {
-      const result = await getJson(`/api/tree?product=${encodeURIComponent(state.product)}`);
-      const roots = result?.data?.roots || [];
+      // The first page of roots is fetched before the old tree is dropped,
+      // so a reload does not flash an empty view.
+      const epoch = ++tree.epoch;
+      const data = await fetchTreePage('', 0);
+      if (epoch !== tree.epoch) return;
+      tree.nodes.clear();
+      tree.children.clear();
+      tree.loading.clear();
+      storeTreePage('', data);
       if (!state.treeTouched && state.treeOpen.size === 0) {
-        for (const root of roots) {
-          if (root.id) state.treeOpen.add(root.id);
-        }
+        tree.children.get('').ids.forEach((id) => state.treeOpen.add(id));
       }
-      document.getElementById('tree').innerHTML = `<ul>${roots.map((node) => renderTreeNode(node, 0)).join('')}</ul>`;
-      bindTreeToggles();
+      rebuildTreeRows();
     }
 
-    async function loadKanban() {
+)JS"
+R"JS(    // Cards of the current board (product, query and types): per-lane
+    // totals, and pages keyed "<lane>:<page>". The previous board's pages
+    // stay on screen until their replacements arrive.
+    const kanban = { totals: {}, pages: new Map(), stale: new Map(), loading: new Set(), epoch: 0 };
+
+    function kanbanUrl() {
       const q = state.q ? `&q=${encodeURIComponent(state.q)}` : '';
-      const result = await getJson(`/api/kanban?product=${encodeURIComponent(state.product)}${q}`);
-      const lanesData = result?.data?.lanes || {};
-      const html = lanes.map((lane) => {
-        const cards = (lanesData[lane] || [])
-          .filter((item) => state.kanbanTypes.has(item.type))
-          .map((item) =>
-          `<div class="card"><div><code>${esc(item.id)}</code></div><div><a href="#" class="item-link" data-item-id="${escAttr(item.id)}">${esc(item.title)}</a></div><div class="muted">${esc(item.type)} / ${esc(item.state)} / ${esc(item.source_kind || '')}</div></div>`
-          ).join('');
-        return `<div class="lane"><strong>${lane}</strong>${cards || '<div class="muted">No items</div>'}</div>`;
-      }).join('');
-      document.getElementById('kanban').innerHTML = html;
-      document.querySelectorAll('#kanban .item-link[data-item-id]').forEach((link) => {
-        link.addEventListener('click', async (event) => {
-          event.preventDefault();
-          const id = link.getAttribute('data-item-id');
-          if (!id) return;
-          await openItemModal(id);
+      const types = encodeURIComponent([...state.kanbanTypes].sort().join(','));
+      return `/api/kanban?product=${encodeURIComponent(state.product)}${q}&type=${types}`;
+    }
+
+    async function loadKanbanPage(lane, page) {
+      const key = `${lane}:${page}`;
+      if (kanban.loading.has(key)) return;
+      const epoch = kanban.epoch;
+      kanban.loading.add(key);
+      const result = await getJson(`${kanbanUrl()}&lane=${lane}&offset=${page * kanbanPageSize}&limit=${kanbanPageSize}&fields=${cardFields}`).catch(() => null);
+      if (epoch !== kanban.epoch) return;
+      kanban.loading.delete(key);
+      kanban.pages.set(key, result?.data?.lanes?.[lane] || []);
+      renderLaneWindow(lane);
+    }
+
+    // Keeps the kanbanPagesKept pages of lane closest to page.
+    function trimKanbanPages(lane, page) {
+      const keys = [...kanban.pages.keys()].filter((key) => key.startsWith(`${lane}:`));
+      if (keys.length <= kanbanPagesKept) return;
+      const distance = (key) => Math.abs(Number(key.slice(lane.length + 1)) - page);
+      keys.sort((a, b) => distance(a) - distance(b));
+      keys.slice(kanbanPagesKept).forEach((key) => kanban.pages.delete(key));
+    }
+
+    function renderLaneWindow(lane) {
+      const box = document.querySelector(`#kanban .lane-box[data-lane="${lane}"]`);
+      if (!box) return;
+      const total = kanban.totals[lane] || 0;
+      const spacer = box.firstElementChild;
+      spacer.style.height = `${total * cardHeight}px`;
+      if (!total) {
+        spacer.innerHTML = '<div class="muted">No items</div>';
+        return;
+      }
+      const [first, last] = visibleRange(box, cardHeight, total);
+      let html = '';
+      for (let i = first; i < last; i++) {
+        const page = Math.floor(i / kanbanPageSize);
+        const key = `${lane}:${page}`;
+        if (!kanban.pages.has(key)) loadKanbanPage(lane, page);
+        const item = (kanban.pages.get(key) || kanban.stale.get(key) || [])[i - page * kanbanPageSize];
+        const style = `top:${i * cardHeight}px`;
+        html += item
+          ? `<div class="card vcard" style="${style}"><div><code>${esc(item.id)}</code></div><div><a href="#" class="item-link" data-item-id="${escAttr(item.id)}">${esc(item.title)}</a></div><div class="muted">${esc(item.type)} / ${esc(item.state)} / ${esc(item.source_kind || '')}</div></div>`
+          : `<div class="card vcard muted" style="${style}">Loading…</div>`;
+      }
+      spacer.innerHTML = html;
+      trimKanbanPages(lane, Math.floor(first / kanbanPageSize));
+    }
+
+    function renderKanbanWindows() {
+      const board = document.getElementById('kanban');
+      if (!board.querySelector('.lane-box')) {
+        board.innerHTML = lanes.map((lane) =>
+          `<div class="lane"><strong>${lane}</strong> <span class="muted lane-count" data-lane="${lane}"></span><div class="vbox lane-box" data-lane="${lane}"><div class="vspacer"></div></div></div>`).join('');
+        board.querySelectorAll('.lane-box').forEach((box) => {
+          box.addEventListener('scroll', () => scheduleRender(box.dataset.lane, () => renderLaneWindow(box.dataset.lane)));
         });
+      }
+      board.querySelectorAll('.lane-count').forEach((count) => {
+        count.textContent = String(kanban.totals[count.dataset.lane] || 0);
       });
+      lanes.forEach(renderLaneWindow);
+    }
+
+    async function loadKanban() {
+      // Totals first, from the cheap counts-only form; cards follow per page.
+      const epoch = ++kanban.epoch;
+      let totals = {};
+      if (state.kanbanTypes.size > 0) {
+        const result = await getJson(`${kanbanUrl()}&counts=1`);
+        if (epoch !== kanban.epoch) return;
+        totals = result?.data?.totals || {};
+      }
+      kanban.totals = totals;
+      kanban.stale = kanban.pages;
+      kanban.pages = new Map();
+      kanban.loading.clear();
+      renderKanbanWindows();
     }
 
     async function loadContext() {
       const q = state.q ? `&q=${encodeURIComponent(state.q)}` : '';
-      const result = await getJson(`/api/items?product=${encodeURIComponent(state.product)}${q}`);
-      const items = (result?.data?.items || []);
-      state.allItems = items;
-      const contextItems = items.filter((item) => {
-        const t = item.type;
-        return t === 'ADR' || t === 'Topic' || t === 'Workset';
-      });
+      const result = await getJson(`/api/items?product=${encodeURIComponent(state.product)}${q}&type=ADR,Topic,Workset&fields=${cardFields}`);
+      const contextItems = (result?.data?.items || []);
 
       const counts = contextItems.reduce((acc, item) => {
         acc[item.type] = (acc[item.type] || 0) + 1;
@@ -610,15 +888,6 @@ R"HTML(    function typeIcon(type) {
         `<div class="card"><div><code>${esc(item.id)}</code></div><div><a href="#" class="item-link" data-item-id="${escAttr(item.id)}">${esc(item.title)}</a></div><div class="muted">${esc(item.type)} / ${esc(item.state)} / ${esc(item.source_kind || '')}</div></div>`
       ).join('');
       document.getElementById('context-list').innerHTML = listHtml || '<div class="muted">No context items</div>';
-
-      document.querySelectorAll('#context-list .item-link[data-item-id]').forEach((link) => {
-        link.addEventListener('click', async (event) => {
-          event.preventDefault();
-          const id = link.getAttribute('data-item-id');
-          if (!id) return;
-          await openItemModal(id);
-        });
-      });
     }
 
     function setActiveTab(tab) {
@@ -632,6 +901,9 @@ R"HTML(    function typeIcon(type) {
       document.getElementById('page-tree').classList.toggle('active', isTree);
       document.getElementById('page-kanban').classList.toggle('active', isKanban);
       document.getElementById('page-context').classList.toggle('active', isContext);
+      // Hidden boxes have no height, so their windows are redrawn on show.
+      if (isTree) renderTreeWindow();
+      if (isKanban) lanes.forEach(renderLaneWindow);
     }
 
     async function refreshAll() {
@@ -640,14 +912,65 @@ R"HTML(    function typeIcon(type) {
         return;
       }
       document.getElementById('status').textContent = 'Loading...';
+      forgetItems(null);
       await Promise.all([loadTree(), loadKanban(), loadContext()]);
       document.getElementById('status').textContent = `Loaded ${state.product}`;
     }
 
+)JS"
+R"JS(    // Live updates: the server pushes a frame per snapshot generation bump
+    // with the ids that were added, changed or removed.
+    let changeSource = null;
+
+    function watchChanges() {
+      if (changeSource) {
+        changeSource.close();
+        changeSource = null;
+      }
+      state.generation = null;
+      if (!state.product || !window.EventSource) return;
+      const product = state.product;
+      changeSource = new EventSource(`/api/events?product=${encodeURIComponent(product)}`);
+      changeSource.addEventListener('hello', async (event) => {
+        const data = JSON.parse(event.data);
+        const known = state.generation;
+        state.generation = data.generation;
+        // After a reconnect the hello may be ahead of what is on screen.
+        if (known !== null && known !== data.generation && product === state.product) {
+          await refreshAll();
+        }
+      });
+      changeSource.addEventListener('changes', async (event) => {
+        const change = JSON.parse(event.data);
+        if (change.product !== state.product) return;
+        state.generation = change.generation;
+        await applyChanges(change);
+      });
+    }
+
+    async function applyChanges(change) {
+      const touched = change.reset ? null : [...change.added, ...change.changed, ...change.removed];
+      if (touched && touched.length === 0) return;
+      forgetItems(touched);
+      // The views are filtered and ranked on the server, so re-read them; each
+      // is one memoized payload for the new generation. Only the open item
+      // is re-fetched, and only when it is among the touched ids.
+      await Promise.all([loadTree(), loadKanban(), loadContext()]);
+      if (state.openItemId && (!touched || touched.includes(state.openItemId))) {
+        await openItemModal(state.openItemId);
+      }
+      document.getElementById('status').textContent = touched
+          ? `Updated ${touched.length} item(s) in ${state.product}`
+          : `Reloaded ${state.product}`;
+    }
+
     document.getElementById('product').addEventListener('change', async (e) => {
       state.product = e.target.value;
       state.treeOpen.clear();
       state.treeTouched = false;
+      state.treeExpandAll = false;
+      state.treeClosed.clear();
+      watchChanges();
       await refreshAll();
     });
 
@@ -709,21 +1032,40 @@ R"HTML(    function typeIcon(type) {
     });
 
     document.getElementById('expand-all').addEventListener('click', () => {
-      document.querySelectorAll('#tree details[data-node-id]').forEach((detail) => {
-        detail.open = true;
-        const id = detail.getAttribute('data-node-id');
-        if (id) state.treeOpen.add(id);
-      });
+      // Children still load a page at a time as they scroll into view.
+      state.treeExpandAll = true;
+      state.treeClosed.clear();
       state.treeTouched = true;
+      rebuildTreeRows();
     });
 
     document.getElementById('collapse-all').addEventListener('click', () => {
-      document.querySelectorAll('#tree details[data-node-id]').forEach((detail) => {
-        detail.open = false;
-      });
+      state.treeExpandAll = false;
       state.treeOpen.clear();
+      state.treeClosed.clear();
       state.treeTouched = true;
+      rebuildTreeRows();
+    });
+
+    // The views redraw on scroll, so links and toggles are handled by one
+    // listener per container.
+    document.getElementById('tree').addEventListener('click', (event) => {
+      const toggle = event.target.closest('[data-toggle-id]');
+      if (toggle) toggleTreeNode(toggle.dataset.toggleId);
+    });
+    ['tree', 'kanban', 'context-list'].forEach((container) => {
+      document.getElementById(container).addEventListener('click', async (event) => {
+        const link = event.target.closest('.item-link[data-item-id]');
+        if (!link) return;
+        event.preventDefault();
+        await openItemModal(link.getAttribute('data-item-id'));
+      });
     });
+    document.getElementById('tree').addEventListener('scroll', () => scheduleRender('tree', renderTreeWindow));
+    window.addEventListener('resize', () => scheduleRender('resize', () => {
+      renderTreeWindow();
+      lanes.forEach(renderLaneWindow);
+    }));
 
     document.getElementById('item-modal-close').addEventListener('click', closeModal);
     document.getElementById('item-modal-backdrop').addEventListener('click', (event) => {
@@ -739,20 +1081,52 @@ R"HTML(    function typeIcon(type) {
       await loadWorkspaceInfo();
       document.getElementById('workspace-input').value = state.workspace || '';
       await loadProducts();
+      watchChanges();
       await refreshAll();
     })();
-  </script>
-</body>
-</html>
-)HTML";
+)JS";
 
 }  // namespace
 
 int main(int argc, char** argv) {
-  const auto productsRoot = ResolveProductsRoot(argc, argv);
-  const auto port = ResolvePort(argc, argv);
+  std::filesystem::path productsRoot;
+  size_t port = 0;
+  size_t httpThreads = 0;
+  // Defaults come from BacklogWebviewOptions itself.
+  kano::backlog::webview::BacklogWebviewOptions options;
+  try {
+    productsRoot = ResolveProductsRoot(argc, argv);
+    port = SizeOption(argc, argv, "--port", "KANO_WEBVIEW_PORT", 8787);
+    if (port == 0 || port > std::numeric_limits<uint16_t>::max()) {
+      throw std::invalid_argument("--port must be between 1 and 65535");
+    }
+    // 0 is one per hardware thread.
+    httpThreads = SizeOption(argc, argv, "--threads", "KANO_WEBVIEW_THREADS", 0);
+    options.loadThreads =
+        SizeOption(argc, argv, "--load-threads", "KANO_WEBVIEW_LOAD_THREADS", options.loadThreads);
+    options.ioThreads =
+        SizeOption(argc, argv, "--io-threads", "KANO_WEBVIEW_IO_THREADS", options.ioThreads);
+    options.lazyContent = BoolOption(argc, argv, "--lazy-content", "KANO_WEBVIEW_LAZY_CONTENT",
+                                     options.lazyContent);
+    options.contentCacheBytes =
+        MebibyteOption(argc, argv, "--content-cache-mb", "KANO_WEBVIEW_CONTENT_CACHE_MB",
+                       options.contentCacheBytes);
+    options.persistentIndex = BoolOption(argc, argv, "--index-cache", "KANO_WEBVIEW_INDEX_CACHE",
+                                         options.persistentIndex);
+    options.warmOnStart =
+        BoolOption(argc, argv, "--no-warmup", "KANO_WEBVIEW_WARMUP", options.warmOnStart);
+    options.workspaceCacheBytes =
+        MebibyteOption(argc, argv, "--workspace-cache-mb", "KANO_WEBVIEW_WORKSPACE_CACHE_MB",
+                       options.workspaceCacheBytes);
+  } catch (const std::invalid_argument& error) {
+    std::cerr << "kano_backlog_webview: " << error.what() << "\n";
+    return 2;
+  }
+  if (httpThreads == 0) {
+    httpThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
 
-  kano::backlog::webview::BacklogWebviewService service(productsRoot);
+  kano::backlog::webview::BacklogWebviewService service(productsRoot, options);
 
   auto appendMeta = [&](const drogon::HttpRequestPtr&, Json::Value& body) {
     body["meta"]["products_root"] = service.GetProductsRoot().generic_string();
@@ -760,21 +1134,23 @@ int main(int argc, char** argv) {
 
   kano::backlog::webview::RegisterBacklogWebviewRoutes(service, appendMeta);
 
-  drogon::app().registerHandler(
-      "/",
-      [](const drogon::HttpRequestPtr&,
-         std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
-        auto response = drogon::HttpResponse::newHttpResponse();
-        response->setStatusCode(drogon::k200OK);
-        response->setContentTypeCode(drogon::CT_TEXT_HTML);
-        response->setBody(kIndexHtml);
-        callback(response);
-      },
-      {drogon::Get});
+  // The shell revalidates on every load; the script URL changes with its
+  // content and can be cached for good.
+  const std::string scriptUrl =
+      "/assets/app-" + kano::backlog::webview::StaticAssetVersion(kIndexScript) + ".js";
+  std::string indexHtml = kIndexHtml;
+  constexpr std::string_view kScriptUrlPlaceholder = "@APP_SCRIPT_URL@";
+  indexHtml.replace(indexHtml.find(kScriptUrlPlaceholder), kScriptUrlPlaceholder.size(),
+                    scriptUrl);
+  kano::backlog::webview::RegisterStaticAsset(scriptUrl, kIndexScript,
+                                              "text/javascript; charset=utf-8",
+                                              "public, max-age=31536000, immutable");
+  kano::backlog::webview::RegisterStaticAsset("/", std::move(indexHtml),
+                                              "text/html; charset=utf-8", "no-cache");
 
   drogon::app().setLogLevel(trantor::Logger::kWarn);
-  drogon::app().setThreadNum(1);
-  drogon::app().addListener("127.0.0.1", port);
+  drogon::app().setThreadNum(httpThreads);
+  drogon::app().addListener("127.0.0.1", static_cast<uint16_t>(port));
   drogon::app().run();
   return 0;
 }
@@ -0,0 +1,200 @@
+#include "KanoBacklog.BenchReport.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace kano::backlog::webview::bench {
+
+namespace {
+
+// Nearest rank on sorted samples.
+double Percentile(const std::vector<double>& sorted, const double fraction) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+double Round(const double value) {
+  return std::round(value * 1000.0) / 1000.0;
+}
+
+struct Check {
+  const char* metric;
+  bool higherIsWorse;
+  // Regressions are worse by more than this, and (when relative) by more
+  // than the tolerance times the baseline.
+  double minDelta;
+  bool relative;
+};
+
+// Latency changes under 50 us are timer and scheduling noise, whatever
+// the ratio.
+constexpr Check kChecks[] = {{"p50_ms", true, 0.05, true},
+                             {"p99_ms", true, 0.05, true},
+                             {"requests_per_sec", false, 0.0, true},
+                             {"errors", true, 0.0, false}};
+constexpr Check kPeakRss = {"peak_rss_bytes", true, 0.0, true};
+
+// Config without the members that differ between runs of the same setup,
+// as compact text: a parsed report holds counts as ints where a fresh one
+// has uints, and Json::Value equality tells those apart.
+std::string StableConfig(Json::Value config) {
+  config.removeMember("products_root");
+  config.removeMember("generate_ms");
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  return Json::writeString(builder, config);
+}
+
+void AddCheck(Json::Value& comparison, const std::string& name, const Check& rule,
+              const double before, const double after, const double tolerance) {
+  const double worse = rule.higherIsWorse ? after - before : before - after;
+  const bool regression = worse > rule.minDelta && (!rule.relative || worse > tolerance * before);
+
+  Json::Value check(Json::objectValue);
+  check["name"] = name;
+  check["metric"] = rule.metric;
+  check["baseline"] = before;
+  check["current"] = after;
+  check["change"] = before > 0.0 ? Round((after - before) / before) : 0.0;
+  check["regression"] = regression;
+  comparison["checks"].append(std::move(check));
+  comparison["compared"] = comparison["compared"].asUInt64() + 1;
+  if (regression) {
+    comparison["regressions"] = comparison["regressions"].asUInt64() + 1;
+  }
+}
+
+}  // namespace
+
+Json::Value Summarize(const std::string& name, std::vector<double> samplesMs) {
+  std::sort(samplesMs.begin(), samplesMs.end());
+  const double total = std::accumulate(samplesMs.begin(), samplesMs.end(), 0.0);
+
+  Json::Value result(Json::objectValue);
+  result["name"] = name;
+  result["iterations"] = static_cast<Json::UInt64>(samplesMs.size());
+  result["total_ms"] = Round(total);
+  result["mean_ms"] = Round(samplesMs.empty() ? 0.0 : total / static_cast<double>(samplesMs.size()));
+  result["min_ms"] = Round(samplesMs.empty() ? 0.0 : samplesMs.front());
+  result["p50_ms"] = Round(Percentile(samplesMs, 0.50));
+  result["p90_ms"] = Round(Percentile(samplesMs, 0.90));
+  result["p99_ms"] = Round(Percentile(samplesMs, 0.99));
+  result["p999_ms"] = Round(Percentile(samplesMs, 0.999));
+  result["max_ms"] = Round(samplesMs.empty() ? 0.0 : samplesMs.back());
+  return result;
+}
+
+Json::Value NewReport(const std::string& mode, const Json::Value& config) {
+  Json::Value report(Json::objectValue);
+  report["schema"] = 1;
+  report["tool"] = "kano_backlog_webview_bench";
+  report["mode"] = mode;
+  report["started_at"] = static_cast<Json::Int64>(std::time(nullptr));
+  report["config"] = config;
+  report["results"] = Json::Value(Json::arrayValue);
+  return report;
+}
+
+bool WriteReport(const Json::Value& report, const std::string& path) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  const auto text = Json::writeString(builder, report) + "\n";
+  if (path.empty()) {
+    std::cout << text;
+    return static_cast<bool>(std::cout);
+  }
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream << text;
+  return static_cast<bool>(stream);
+}
+
+Json::Value ReadReport(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    throw std::runtime_error("Cannot read " + path);
+  }
+  Json::Value report;
+  Json::CharReaderBuilder builder;
+  std::string error;
+  if (!Json::parseFromStream(builder, stream, &report, &error) || !report.isObject()) {
+    throw std::runtime_error("Cannot parse " + path + ": " + error);
+  }
+  return report;
+}
+
+std::uint64_t PeakRssBytes() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>(counters.PeakWorkingSetSize);
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+  // Linux reports kilobytes.
+  return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+Json::Value CompareReports(const Json::Value& baseline, const Json::Value& report,
+                           const double tolerance) {
+  if (baseline["mode"] != report["mode"]) {
+    throw std::runtime_error("Baseline is a " + baseline["mode"].asString() +
+                             " report, not " + report["mode"].asString());
+  }
+  Json::Value comparison(Json::objectValue);
+  comparison["tolerance"] = tolerance;
+  comparison["config_matches"] = StableConfig(baseline["config"]) == StableConfig(report["config"]);
+  comparison["compared"] = Json::UInt64{0};
+  comparison["regressions"] = Json::UInt64{0};
+  comparison["checks"] = Json::Value(Json::arrayValue);
+
+  std::map<std::string, const Json::Value*> before;
+  for (const auto& result : baseline["results"]) {
+    before[result["name"].asString()] = &result;
+  }
+  for (const auto& result : report["results"]) {
+    const auto name = result["name"].asString();
+    const auto it = before.find(name);
+    if (it == before.end()) {
+      continue;
+    }
+    for (const auto& check : kChecks) {
+      const auto& previous = (*it->second)[check.metric];
+      const auto& current = result[check.metric];
+      if (previous.isNumeric() && current.isNumeric()) {
+        AddCheck(comparison, name, check, previous.asDouble(), current.asDouble(), tolerance);
+      }
+    }
+  }
+  if (baseline["peak_rss_bytes"].isNumeric() && report["peak_rss_bytes"].isNumeric()) {
+    AddCheck(comparison, "process", kPeakRss, baseline["peak_rss_bytes"].asDouble(),
+             report["peak_rss_bytes"].asDouble(), tolerance);
+  }
+  return comparison;
+}
+
+}  // namespace kano::backlog::webview::bench
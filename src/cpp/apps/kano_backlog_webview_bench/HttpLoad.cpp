@@ -0,0 +1,211 @@
+#include "KanoBacklog.HttpLoad.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <drogon/drogon.h>
+#include <trantor/net/EventLoopThread.h>
+
+#include "KanoBacklog.BenchReport.hpp"
+
+namespace kano::backlog::webview::bench {
+
+namespace {
+
+struct ConnectionStats {
+  std::vector<std::vector<double>> samples;
+  std::uint64_t requests = 0;
+  std::uint64_t errors = 0;
+  std::uint64_t bytes = 0;
+};
+
+// Splits "/path?a=1&b=2" into a GET request. Values are sent as given.
+drogon::HttpRequestPtr NewRequest(const std::string& target) {
+  auto request = drogon::HttpRequest::newHttpRequest();
+  request->setMethod(drogon::Get);
+  const auto queryPos = target.find('?');
+  request->setPath(target.substr(0, queryPos));
+  if (queryPos == std::string::npos) {
+    return request;
+  }
+  size_t cursor = queryPos + 1;
+  while (cursor <= target.size()) {
+    const auto end = std::min(target.find('&', cursor), target.size());
+    const auto pair = target.substr(cursor, end - cursor);
+    if (!pair.empty()) {
+      const auto equals = pair.find('=');
+      if (equals == std::string::npos) {
+        request->setParameter(pair, "");
+      } else {
+        request->setParameter(pair.substr(0, equals), pair.substr(equals + 1));
+      }
+    }
+    cursor = end + 1;
+  }
+  return request;
+}
+
+constexpr std::string_view kIdPlaceholder = "{id}";
+
+// One cycle of target indices, each weight times, interleaved (smooth
+// weighted round robin) so heavy targets do not arrive in bursts.
+std::vector<size_t> Schedule(const std::vector<HttpTarget>& targets) {
+  std::int64_t totalWeight = 0;
+  for (const auto& target : targets) {
+    totalWeight += static_cast<std::int64_t>(target.weight);
+  }
+  std::vector<std::int64_t> current(targets.size(), 0);
+  std::vector<size_t> order;
+  order.reserve(static_cast<size_t>(totalWeight));
+  for (std::int64_t step = 0; step < totalWeight; ++step) {
+    size_t best = 0;
+    for (size_t target = 0; target < targets.size(); ++target) {
+      current[target] += static_cast<std::int64_t>(targets[target].weight);
+      if (current[target] > current[best]) {
+        best = target;
+      }
+    }
+    current[best] -= totalWeight;
+    order.push_back(best);
+  }
+  return order;
+}
+
+void DriveConnection(const HttpLoadOptions& options, const std::vector<size_t>& schedule,
+                     const size_t connection,
+                     const std::chrono::steady_clock::time_point recordFrom,
+                     const std::chrono::steady_clock::time_point stopAt, ConnectionStats& stats) {
+  trantor::EventLoopThread loopThread("bench-http");
+  loopThread.run();
+  const auto client = drogon::HttpClient::newHttpClient(options.baseUrl, loopThread.getLoop());
+
+  stats.samples.resize(options.targets.size());
+  // Connections start at different points of the schedule and id list so
+  // the mix stays even.
+  size_t next = connection;
+  size_t nextId = connection;
+  while (std::chrono::steady_clock::now() < stopAt) {
+    const auto target = schedule[next++ % schedule.size()];
+    auto path = options.targets[target].path;
+    if (const auto placeholder = path.find(kIdPlaceholder); placeholder != std::string::npos) {
+      path.replace(placeholder, kIdPlaceholder.size(),
+                   options.itemIds[nextId++ % options.itemIds.size()]);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto [result, response] = client->sendRequest(NewRequest(path), options.timeoutSeconds);
+    const auto finish = std::chrono::steady_clock::now();
+    if (start < recordFrom) {
+      continue;
+    }
+    ++stats.requests;
+    if (result != drogon::ReqResult::Ok || !response ||
+        static_cast<int>(response->getStatusCode()) >= 400) {
+      ++stats.errors;
+      continue;
+    }
+    stats.bytes += response->body().size();
+    const std::chrono::duration<double, std::milli> elapsed = finish - start;
+    stats.samples[target].push_back(elapsed.count());
+  }
+}
+
+}  // namespace
+
+Json::Value RunHttpLoad(const HttpLoadOptions& options) {
+  Json::Value results(Json::arrayValue);
+  const auto schedule = Schedule(options.targets);
+  if (schedule.empty() || options.connections == 0) {
+    return results;
+  }
+  for (const auto& target : options.targets) {
+    if (options.itemIds.empty() && target.path.find(kIdPlaceholder) != std::string::npos) {
+      throw std::invalid_argument("No item ids for " + target.path);
+    }
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  const auto recordFrom = begin + options.warmup;
+  const auto stopAt = recordFrom + options.duration;
+  std::vector<ConnectionStats> stats(options.connections);
+  {
+    std::vector<std::jthread> drivers;
+    drivers.reserve(options.connections);
+    for (size_t connection = 0; connection < options.connections; ++connection) {
+      drivers.emplace_back([&, connection] {
+        DriveConnection(options, schedule, connection, recordFrom, stopAt, stats[connection]);
+      });
+    }
+  }
+  const std::chrono::duration<double> measured =
+      std::chrono::steady_clock::now() - recordFrom;
+
+  std::vector<double> all;
+  ConnectionStats totals;
+  for (size_t target = 0; target < options.targets.size(); ++target) {
+    std::vector<double> samples;
+    for (const auto& connection : stats) {
+      samples.insert(samples.end(), connection.samples[target].begin(),
+                     connection.samples[target].end());
+    }
+    all.insert(all.end(), samples.begin(), samples.end());
+    auto summary = Summarize("http " + options.targets[target].name, std::move(samples));
+    summary["target"] = options.targets[target].path;
+    summary["weight"] = static_cast<Json::UInt64>(options.targets[target].weight);
+    results.append(std::move(summary));
+  }
+  for (const auto& connection : stats) {
+    totals.requests += connection.requests;
+    totals.errors += connection.errors;
+    totals.bytes += connection.bytes;
+  }
+
+  auto summary = Summarize("http.all", std::move(all));
+  summary["connections"] = static_cast<Json::UInt64>(options.connections);
+  summary["duration_s"] = measured.count();
+  summary["requests"] = static_cast<Json::UInt64>(totals.requests);
+  summary["errors"] = static_cast<Json::UInt64>(totals.errors);
+  summary["bytes"] = static_cast<Json::UInt64>(totals.bytes);
+  summary["requests_per_sec"] =
+      measured.count() > 0.0 ? static_cast<double>(totals.requests) / measured.count() : 0.0;
+  results.append(std::move(summary));
+  return results;
+}
+
+std::vector<std::string> SampleItemIds(const Json::Value& listing, const size_t limit) {
+  const auto& items = listing["items"];
+  const auto count = static_cast<size_t>(items.size());
+  std::vector<std::string> ids;
+  const auto taken = std::min(count, limit);
+  ids.reserve(taken);
+  for (size_t index = 0; index < taken; ++index) {
+    ids.push_back(items[static_cast<Json::ArrayIndex>(index * count / taken)]["id"].asString());
+  }
+  return ids;
+}
+
+std::vector<std::string> FetchItemIds(const std::string& baseUrl, const std::string& product,
+                                      const size_t limit) {
+  trantor::EventLoopThread loopThread("bench-ids");
+  loopThread.run();
+  const auto client = drogon::HttpClient::newHttpClient(baseUrl, loopThread.getLoop());
+  const auto [result, response] =
+      client->sendRequest(NewRequest("/api/items?product=" + product + "&fields=id"), 30.0);
+  if (result != drogon::ReqResult::Ok || !response ||
+      static_cast<int>(response->getStatusCode()) >= 400) {
+    throw std::runtime_error("Cannot list the items of " + product + " at " + baseUrl);
+  }
+  const auto body = response->body();
+  Json::Value envelope;
+  Json::CharReaderBuilder builder;
+  std::string error;
+  const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+  if (!reader->parse(body.data(), body.data() + body.size(), &envelope, &error)) {
+    throw std::runtime_error("Cannot parse the items of " + product + ": " + error);
+  }
+  return SampleItemIds(envelope["data"], limit);
+}
+
+}  // namespace kano::backlog::webview::bench
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <json/json.h>
+
+namespace kano::backlog::webview::bench {
+
+// Latency summary of one benchmark in milliseconds: name, iterations,
+// total_ms, mean_ms, min_ms, p50_ms, p90_ms, p99_ms, p999_ms and max_ms.
+Json::Value Summarize(const std::string& name, std::vector<double> samplesMs);
+
+// Runs fn warmup times unmeasured, then iterations times, and summarizes
+// the wall time of each measured call.
+template <typename Fn>
+Json::Value Measure(const std::string& name, const size_t warmup, const size_t iterations,
+                    Fn&& fn) {
+  for (size_t i = 0; i < warmup; ++i) {
+    fn();
+  }
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  for (size_t i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    samples.push_back(elapsed.count());
+  }
+  return Summarize(name, std::move(samples));
+}
+
+// Report envelope: {"schema":1,"tool":...,"mode":...,"config":...,"results":[...]}.
+Json::Value NewReport(const std::string& mode, const Json::Value& config);
+
+// Pretty JSON on stdout when path is empty.
+bool WriteReport(const Json::Value& report, const std::string& path);
+
+// A report written by WriteReport; throws std::runtime_error if it cannot
+// be read or parsed.
+Json::Value ReadReport(const std::string& path);
+
+// Peak resident set size of this process in bytes; 0 where unknown.
+std::uint64_t PeakRssBytes();
+
+// Checks report against an earlier one of the same mode. Results are
+// matched by name; p50_ms, p99_ms, requests_per_sec and peak_rss_bytes
+// regress when they are worse by more than tolerance (a fraction of the
+// baseline), errors when there are more of them. Returns
+// {"tolerance","config_matches","compared","regressions","checks":[...]}.
+Json::Value CompareReports(const Json::Value& baseline, const Json::Value& report,
+                           double tolerance);
+
+}  // namespace kano::backlog::webview::bench
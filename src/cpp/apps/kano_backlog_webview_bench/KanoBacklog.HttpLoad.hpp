@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+namespace kano::backlog::webview::bench {
+
+struct HttpTarget {
+  // Result name ("items", or the path for --target).
+  std::string name;
+  // "/api/tree?product=x"; "{id}" is replaced by the next of itemIds.
+  std::string path;
+  // Share of the requests, relative to the other targets.
+  size_t weight = 1;
+};
+
+struct HttpLoadOptions {
+  // Scheme, host and port, e.g. "http://127.0.0.1:8787".
+  std::string baseUrl;
+  // Every connection cycles through the targets in proportion to weight.
+  std::vector<HttpTarget> targets;
+  // Substituted for "{id}", round robin per connection.
+  std::vector<std::string> itemIds;
+  // Keep-alive connections, each driven by its own thread in a closed loop.
+  size_t connections = 8;
+  std::chrono::milliseconds duration{10000};
+  // Requests sent before this are not recorded.
+  std::chrono::milliseconds warmup{1000};
+  double timeoutSeconds = 10.0;
+};
+
+// Drives GET requests at the targets and returns one latency summary per
+// target plus an "http.all" entry with requests, errors, bytes and
+// requests_per_sec. Blocks until the run is over; must not be called from
+// a drogon event loop thread.
+Json::Value RunHttpLoad(const HttpLoadOptions& options);
+
+// Up to limit ids of an items listing ({"items": [{"id": ...}]}), evenly
+// spaced over it so detail requests do not all hit its first page.
+std::vector<std::string> SampleItemIds(const Json::Value& listing, size_t limit);
+
+// SampleItemIds over product's /api/items on a running server.
+std::vector<std::string> FetchItemIds(const std::string& baseUrl, const std::string& product,
+                                      size_t limit);
+
+}  // namespace kano::backlog::webview::bench
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace kano::backlog::webview::bench {
+
+struct SyntheticOptions {
+  size_t products = 1;
+  // Work items per product.
+  size_t items = 2000;
+  // Hierarchy levels: Epic, Feature, UserStory on top, Task/Bug leaves at
+  // the bottom (extra levels in between are Tasks). 1 is a flat backlog.
+  size_t depth = 4;
+  // Children per parent while the levels fill breadth first.
+  size_t fanout = 6;
+  // Fraction of item ids written a second time with a newer timestamp.
+  double duplicates = 0.01;
+  // ADRs per product.
+  size_t decisions = 20;
+  // Workspace-level topics/ and worksets/ entries.
+  size_t topics = 20;
+  size_t worksets = 10;
+  // Approximate markdown body size per item.
+  size_t bodyBytes = 600;
+  std::uint32_t seed = 1;
+};
+
+struct SyntheticBacklog {
+  std::filesystem::path productsRoot;
+  std::vector<std::string> products;
+  // A leaf item file of the first product, for incremental edits.
+  std::filesystem::path sampleItemPath;
+  size_t files = 0;
+  std::uintmax_t bytes = 0;
+};
+
+// Writes a backlog workspace under workspace/_kano/backlog in the layout the
+// service loads. Output is deterministic for a given seed. Existing
+// products/, topics/ and worksets/ directories there are replaced.
+SyntheticBacklog GenerateSyntheticBacklog(const std::filesystem::path& workspace,
+                                          const SyntheticOptions& options);
+
+}  // namespace kano::backlog::webview::bench
@@ -0,0 +1,276 @@
+#include "KanoBacklog.SyntheticBacklog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+
+namespace kano::backlog::webview::bench {
+
+namespace {
+
+// Written next to products/ so a later run may replace what it generated,
+// and only that.
+constexpr std::string_view kMarkerFile = ".kano_bench_generated";
+
+constexpr std::array<std::string_view, 32> kWords = {
+    "cache",   "index",    "render",  "parser",  "backlog", "sync",    "export",  "import",
+    "search",  "kanban",   "tree",    "filter",  "session", "token",   "config",  "watcher",
+    "stream",  "snapshot", "latency", "lane",    "schema",  "migrate", "report",  "retry",
+    "deploy",  "review",   "metrics", "release", "switch",  "product", "monitor", "audit"};
+
+constexpr std::array<std::string_view, 6> kStates = {"Proposed", "Ready",  "InProgress",
+                                                      "Blocked",  "Review", "Done"};
+
+struct ItemType {
+  std::string_view name;
+  std::string_view code;
+  std::string_view folder;
+};
+
+constexpr ItemType kEpic{"Epic", "EPI", "epic"};
+constexpr ItemType kFeature{"Feature", "FTR", "feature"};
+constexpr ItemType kStory{"UserStory", "USR", "userstory"};
+constexpr ItemType kTask{"Task", "TSK", "task"};
+constexpr ItemType kBug{"Bug", "BUG", "bug"};
+
+// Epic, Feature, UserStory from the top for as many levels as there are
+// above the leaves; any further inner levels are Tasks.
+const ItemType& InnerType(const size_t level) {
+  static constexpr std::array<const ItemType*, 3> kInner = {&kEpic, &kFeature, &kStory};
+  return level < kInner.size() ? *kInner[level] : kTask;
+}
+
+std::string Prefix(const std::string& product) {
+  std::string prefix;
+  for (const char c : product) {
+    if (c >= 'a' && c <= 'z') {
+      prefix.push_back(static_cast<char>(c - 'a' + 'A'));
+    } else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+      prefix.push_back(c);
+    }
+  }
+  return prefix;
+}
+
+std::string Padded(const size_t value, const int width) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%0*zu", width, value);
+  return buffer;
+}
+
+std::string Timestamp(std::mt19937& rng, const int year) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02uT%02u:%02u:%02uZ", year,
+                1 + static_cast<unsigned>(rng() % 12), 1 + static_cast<unsigned>(rng() % 28),
+                static_cast<unsigned>(rng() % 24), static_cast<unsigned>(rng() % 60),
+                static_cast<unsigned>(rng() % 60));
+  return buffer;
+}
+
+std::string Words(std::mt19937& rng, const size_t count) {
+  std::string out;
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      out.push_back(' ');
+    }
+    out.append(kWords[rng() % kWords.size()]);
+  }
+  return out;
+}
+
+class Writer {
+ public:
+  explicit Writer(SyntheticBacklog& output) : output(output) {}
+
+  void Write(const std::filesystem::path& path, const std::string& content) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!stream) {
+      throw std::runtime_error("Failed to write " + path.string());
+    }
+    ++output.files;
+    output.bytes += content.size();
+  }
+
+ private:
+  SyntheticBacklog& output;
+};
+
+struct GeneratedItem {
+  std::string id;
+  const ItemType* type;
+  size_t level;
+  size_t parent;
+};
+
+constexpr size_t kNoParent = static_cast<size_t>(-1);
+
+// A breadth-first forest: roots are sized so that depth levels of fanout
+// children hold about options.items items, and overflow below the last level is
+// spread over random parents one level up.
+std::vector<GeneratedItem> BuildForest(const std::string& prefix, const SyntheticOptions& options,
+                                       std::mt19937& rng) {
+  const size_t depth = std::max<size_t>(options.depth, 1);
+  const size_t fanout = std::max<size_t>(options.fanout, 1);
+  double perRoot = 0.0;
+  for (size_t level = 0; level < depth; ++level) {
+    perRoot += std::pow(static_cast<double>(fanout), static_cast<double>(level));
+  }
+  const auto roots = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil(static_cast<double>(options.items) / perRoot)));
+
+  std::vector<GeneratedItem> items;
+  items.reserve(options.items);
+  std::vector<size_t> lastInner;
+  for (size_t index = 0; index < options.items; ++index) {
+    GeneratedItem item{{}, nullptr, 0, kNoParent};
+    if (depth > 1 && index >= roots) {
+      item.parent = (index - roots) / fanout;
+      item.level = items[item.parent].level + 1;
+      if (item.level >= depth) {
+        item.parent = lastInner[rng() % lastInner.size()];
+        item.level = depth - 1;
+      }
+    }
+    if (item.level + 1 < depth) {
+      item.type = &InnerType(item.level);
+    } else {
+      item.type = rng() % 5 == 0 ? &kBug : &kTask;
+    }
+    if (depth > 1 && item.level == depth - 2) {
+      lastInner.push_back(index);
+    }
+    item.id = prefix + "-" + std::string(item.type->code) + "-" + Padded(index + 1, 6);
+    items.push_back(std::move(item));
+  }
+  return items;
+}
+
+std::string ItemFile(const GeneratedItem& item, const std::string& parent, std::mt19937& rng,
+                     const SyntheticOptions& options, const std::string& updated) {
+  const auto title = Words(rng, 3 + rng() % 4);
+  std::string content;
+  content.reserve(options.bodyBytes + 512);
+  content += "---\nid: " + item.id + "\n";
+  content += "uid: bench-" + item.id + "\n";
+  content += "type: " + std::string(item.type->name) + "\n";
+  content += "title: \"" + title + "\"\n";
+  content += "state: " + std::string(kStates[rng() % kStates.size()]) + "\n";
+  content += "priority: P" + std::to_string(rng() % 4) + "\n";
+  content += "parent: " + (parent.empty() ? std::string("null") : parent) + "\n";
+  content += "owner: null\n";
+  content += "tags:\n  - bench\n  - level-" + std::to_string(item.level) + "\n";
+  content += "created: 2025-" + Padded(1 + rng() % 12, 2) + "-" + Padded(1 + rng() % 28, 2) + "\n";
+  content += "updated: " + updated + "\n";
+  content += "---\n\n# " + title + "\n\n";
+  if (!parent.empty()) {
+    content += "Part of [[" + parent + "]].\n\n";
+  }
+  const size_t bodyStart = content.size();
+  while (content.size() - bodyStart < options.bodyBytes) {
+    content += Words(rng, 12) + ".\n";
+  }
+  return content;
+}
+
+void GenerateProduct(const std::filesystem::path& productRoot, const std::string& product,
+                     const SyntheticOptions& options, std::mt19937& rng, Writer& writer,
+                     SyntheticBacklog& output, const bool sample) {
+  const auto items = BuildForest(Prefix(product), options, rng);
+  const auto itemPath = [&](const size_t index, const std::string& suffix) {
+    const auto& item = items[index];
+    return productRoot / "items" / std::string(item.type->folder) / Padded(index / 1000, 4) /
+           (item.id + "_" + suffix + ".md");
+  };
+
+  for (size_t index = 0; index < items.size(); ++index) {
+    const auto& item = items[index];
+    const auto parent = item.parent == kNoParent ? std::string() : items[item.parent].id;
+    const auto path = itemPath(index, "item-" + std::to_string(index + 1));
+    writer.Write(path, ItemFile(item, parent, rng, options, Timestamp(rng, 2026)));
+    if (sample && item.level + 1 >= options.depth) {
+      output.sampleItemPath = path;
+    }
+  }
+
+  // Duplicates carry a later year so they win primary selection.
+  const auto duplicates = static_cast<size_t>(
+      std::llround(static_cast<double>(items.size()) * std::clamp(options.duplicates, 0.0, 1.0)));
+  for (size_t copy = 0; copy < duplicates && !items.empty(); ++copy) {
+    const auto index = rng() % items.size();
+    const auto& item = items[index];
+    const auto parent = item.parent == kNoParent ? std::string() : items[item.parent].id;
+    writer.Write(itemPath(index, "duplicate-" + std::to_string(copy + 1)),
+                 ItemFile(item, parent, rng, options, Timestamp(rng, 2027)));
+  }
+
+  for (size_t index = 0; index < options.decisions; ++index) {
+    const auto id = "ADR-" + Padded(index + 1, 4);
+    const auto title = Words(rng, 4);
+    writer.Write(productRoot / "decisions" / (id + "_decision-" + std::to_string(index + 1) + ".md"),
+                 "---\nid: " + id + "\ntitle: \"" + title + "\"\nstatus: Accepted\ndate: 2025-" +
+                     Padded(1 + rng() % 12, 2) + "-" + Padded(1 + rng() % 28, 2) + "\n---\n\n# " +
+                     title + "\n\n" + Words(rng, 40) + ".\n");
+  }
+}
+
+void ReplaceGenerated(const std::filesystem::path& backlogRoot) {
+  const auto marker = backlogRoot / std::string(kMarkerFile);
+  const auto products = backlogRoot / "products";
+  if (std::filesystem::exists(products) && !std::filesystem::is_empty(products) &&
+      !std::filesystem::exists(marker)) {
+    throw std::runtime_error("Refusing to overwrite " + products.string() +
+                             ": it was not written by the generator");
+  }
+  for (const auto* name : {"products", "topics", "worksets", ".cache"}) {
+    std::filesystem::remove_all(backlogRoot / name);
+  }
+  std::filesystem::create_directories(products);
+  std::ofstream(marker, std::ios::trunc) << "kano_backlog_webview_bench\n";
+}
+
+}  // namespace
+
+SyntheticBacklog GenerateSyntheticBacklog(const std::filesystem::path& workspace,
+                                          const SyntheticOptions& options) {
+  const auto backlogRoot = workspace / "_kano" / "backlog";
+  ReplaceGenerated(backlogRoot);
+
+  SyntheticBacklog output;
+  output.productsRoot = backlogRoot / "products";
+  Writer writer(output);
+  std::mt19937 rng(options.seed);
+
+  for (size_t index = 0; index < std::max<size_t>(options.products, 1); ++index) {
+    const auto product = "bench-" + Padded(index + 1, 2);
+    GenerateProduct(output.productsRoot / product, product, options, rng, writer, output,
+                    index == 0);
+    output.products.push_back(product);
+  }
+
+  for (size_t index = 0; index < options.topics; ++index) {
+    const auto slug = "topic-" + Padded(index + 1, 3);
+    const auto dir = backlogRoot / "topics" / slug;
+    writer.Write(dir / "manifest.json",
+                 "{\n  \"topic\": \"" + slug + "\",\n  \"status\": \"open\",\n"
+                 "  \"created_at\": \"2025-06-01T09:00:00Z\",\n  \"updated_at\": \"" +
+                     Timestamp(rng, 2026) + "\"\n}\n");
+    writer.Write(dir / "brief.md", "# " + Words(rng, 4) + "\n\n" + Words(rng, 60) + ".\n");
+  }
+  for (size_t index = 0; index < options.worksets; ++index) {
+    const auto name = "workset-" + Padded(index + 1, 3);
+    writer.Write(backlogRoot / "worksets" / name / "manifest.json",
+                 "{\n  \"name\": \"" + name + "\",\n  \"status\": \"active\",\n"
+                 "  \"created_at\": \"2025-06-01T09:00:00Z\",\n  \"updated_at\": \"" +
+                     Timestamp(rng, 2026) + "\"\n}\n");
+  }
+  return output;
+}
+
+}  // namespace kano::backlog::webview::bench
@@ -0,0 +1,612 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <drogon/drogon.h>
+
+#include "KanoBacklog.BacklogWebviewService.hpp"
+#include "KanoBacklog.BenchReport.hpp"
+#include "KanoBacklog.HttpLoad.hpp"
+#include "KanoBacklog.SyntheticBacklog.hpp"
+
+import KanoBacklogWebview.Frontmatter;
+import KanoBacklogWebview.Strings;
+
+namespace {
+
+namespace webview = kano::backlog::webview;
+namespace bench = kano::backlog::webview::bench;
+
+constexpr const char* kUsage =
+    "usage: kano_backlog_webview_bench <generate|micro|http> [options]\n"
+    "\n"
+    "  generate --workspace <dir>        write a synthetic backlog and exit\n"
+    "  micro    [--backlog-root <dir>]   parse/load/serialize microbenchmarks\n"
+    "  http     [--backlog-root <dir> | --url <base>]\n"
+    "                                    HTTP load against an in-process or running server\n"
+    "\n"
+    "generator: --products N --items N --depth N --fanout N --duplicates F\n"
+    "           --decisions N --topics N --worksets N --body-bytes N --seed N\n"
+    "           --workspace <dir> (micro/http generate into a temp dir otherwise) --keep\n"
+    "micro:     --iterations N --load-iterations N --warmup N\n"
+    "http:      --product <name> --mix name=W,... | --target <path> (repeatable)\n"
+    "           --connections N --duration-s S --warmup-s S --port N --threads N --ids N\n"
+    "service:   --load-threads N --io-threads N --lazy-content --index-cache\n"
+    "output:    --json <file> (stdout by default)\n"
+    "baseline:  --baseline <report.json> --tolerance F (exit 3 on a regression)\n";
+
+// "--name value" pairs; a flag followed by another flag (or nothing) reads as "1".
+class Args {
+ public:
+  Args(const int argc, char** argv, const int first) {
+    for (int i = first; i < argc; ++i) {
+      std::string name = argv[i];
+      if (name.rfind("--", 0) != 0) {
+        throw std::invalid_argument("Unexpected argument: " + name);
+      }
+      name.erase(0, 2);
+      if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+        values[name].push_back(argv[++i]);
+      } else {
+        values[name].push_back("1");
+      }
+    }
+  }
+
+  bool Has(const std::string& name) const { return values.count(name) > 0; }
+
+  std::string Get(const std::string& name, const std::string& fallback = {}) const {
+    const auto it = values.find(name);
+    return it == values.end() ? fallback : it->second.back();
+  }
+
+  std::vector<std::string> GetAll(const std::string& name) const {
+    const auto it = values.find(name);
+    return it == values.end() ? std::vector<std::string>{} : it->second;
+  }
+
+  size_t GetSize(const std::string& name, const size_t fallback) const {
+    return Has(name) ? static_cast<size_t>(std::stoull(Get(name))) : fallback;
+  }
+
+  double GetDouble(const std::string& name, const double fallback) const {
+    return Has(name) ? std::stod(Get(name)) : fallback;
+  }
+
+ private:
+  std::map<std::string, std::vector<std::string>> values;
+};
+
+bench::SyntheticOptions ResolveSyntheticOptions(const Args& args) {
+  bench::SyntheticOptions options;
+  options.products = args.GetSize("products", options.products);
+  options.items = args.GetSize("items", options.items);
+  options.depth = args.GetSize("depth", options.depth);
+  options.fanout = args.GetSize("fanout", options.fanout);
+  options.duplicates = args.GetDouble("duplicates", options.duplicates);
+  options.decisions = args.GetSize("decisions", options.decisions);
+  options.topics = args.GetSize("topics", options.topics);
+  options.worksets = args.GetSize("worksets", options.worksets);
+  options.bodyBytes = args.GetSize("body-bytes", options.bodyBytes);
+  options.seed = static_cast<std::uint32_t>(args.GetSize("seed", options.seed));
+  return options;
+}
+
+webview::BacklogWebviewOptions ResolveServiceOptions(const Args& args) {
+  webview::BacklogWebviewOptions options;
+  options.loadThreads = args.GetSize("load-threads", options.loadThreads);
+  options.ioThreads = args.GetSize("io-threads", options.ioThreads);
+  options.lazyContent = args.Has("lazy-content");
+  options.persistentIndex = args.Has("index-cache");
+  // Off unless asked for, so cold loads are measured cold.
+  options.warmOnStart = args.Has("warm-on-start");
+  return options;
+}
+
+Json::Value SyntheticConfig(const bench::SyntheticOptions& options) {
+  Json::Value config(Json::objectValue);
+  config["products"] = static_cast<Json::UInt64>(options.products);
+  config["items"] = static_cast<Json::UInt64>(options.items);
+  config["depth"] = static_cast<Json::UInt64>(options.depth);
+  config["fanout"] = static_cast<Json::UInt64>(options.fanout);
+  config["duplicates"] = options.duplicates;
+  config["decisions"] = static_cast<Json::UInt64>(options.decisions);
+  config["topics"] = static_cast<Json::UInt64>(options.topics);
+  config["worksets"] = static_cast<Json::UInt64>(options.worksets);
+  config["body_bytes"] = static_cast<Json::UInt64>(options.bodyBytes);
+  config["seed"] = options.seed;
+  return config;
+}
+
+// The backlog a mode runs against: an existing products root, or a
+// synthetic one generated for the run (and removed after it unless --keep).
+class Workload {
+ public:
+  explicit Workload(const Args& args) : options(ResolveSyntheticOptions(args)) {
+    keep = args.Has("keep");
+    if (args.Has("backlog-root")) {
+      productsRoot = args.Get("backlog-root");
+      for (const auto& entry : std::filesystem::directory_iterator(productsRoot)) {
+        if (entry.is_directory() && entry.path().filename().string().front() != '.') {
+          products.push_back(entry.path().filename().string());
+        }
+      }
+      std::sort(products.begin(), products.end());
+      return;
+    }
+
+    std::filesystem::path workspace = args.Get("workspace");
+    if (workspace.empty()) {
+      const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+      workspace = std::filesystem::temp_directory_path() /
+                  ("kano_backlog_webview_bench-" + std::to_string(stamp));
+      temporary = workspace;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    generated = bench::GenerateSyntheticBacklog(workspace, options);
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    generateMs = elapsed.count();
+    productsRoot = generated->productsRoot;
+    products = generated->products;
+  }
+
+  ~Workload() {
+    if (!temporary.empty() && !keep) {
+      std::error_code ignored;
+      std::filesystem::remove_all(temporary, ignored);
+    }
+  }
+
+  Workload(const Workload&) = delete;
+  Workload& operator=(const Workload&) = delete;
+
+  Json::Value Config() const {
+    Json::Value config(Json::objectValue);
+    config["products_root"] = productsRoot.generic_string();
+    config["synthetic"] = generated.has_value();
+    if (generated) {
+      config["generator"] = SyntheticConfig(options);
+      config["generated_files"] = static_cast<Json::UInt64>(generated->files);
+      config["generated_bytes"] = static_cast<Json::UInt64>(generated->bytes);
+      config["generate_ms"] = generateMs;
+    }
+    return config;
+  }
+
+  bench::SyntheticOptions options;
+  std::filesystem::path productsRoot;
+  std::vector<std::string> products;
+  std::optional<bench::SyntheticBacklog> generated;
+  std::filesystem::path temporary;
+  bool keep = false;
+  double generateMs = 0.0;
+};
+
+// Up to limit loaded item ids, spread over the product.
+std::vector<std::string> ItemIds(webview::BacklogWebviewService& service,
+                                 const std::string& product, const size_t limit) {
+  webview::ItemQuery query;
+  query.fields = {"id"};
+  const auto view = service.GetSerializedView(product, webview::BacklogWebviewService::View::Items,
+                                              query);
+  Json::Value data;
+  Json::CharReaderBuilder builder;
+  std::string error;
+  const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+  if (!reader->parse(view.data->data(), view.data->data() + view.data->size(), &data, &error)) {
+    return {};
+  }
+  return bench::SampleItemIds(data, limit);
+}
+
+// Any loaded item id works for single-item benchmarks.
+std::string FirstItemId(webview::BacklogWebviewService& service, const std::string& product) {
+  const auto ids = ItemIds(service, product, 1);
+  return ids.empty() ? std::string() : ids.front();
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+std::string WriteCompact(const Json::Value& value) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  return Json::writeString(builder, value);
+}
+
+void AddThroughput(Json::Value& result, const std::uintmax_t bytes) {
+  const auto meanMs = result["mean_ms"].asDouble();
+  result["bytes"] = static_cast<Json::UInt64>(bytes);
+  result["mb_per_s"] = meanMs > 0.0 ? static_cast<double>(bytes) / 1e6 / (meanMs / 1000.0) : 0.0;
+}
+
+// Writes the report, compared against --baseline when given. Regressions
+// are listed on stderr and exit with 3, so scripts can gate on them.
+int FinishReport(Json::Value& report, const Args& args) {
+  int status = 0;
+  if (args.Has("baseline")) {
+    const auto path = args.Get("baseline");
+    auto comparison =
+        bench::CompareReports(bench::ReadReport(path), report, args.GetDouble("tolerance", 0.15));
+    comparison["baseline"] = path;
+    if (!comparison["config_matches"].asBool()) {
+      std::cerr << "warning: " << path << " was run with a different config\n";
+    }
+    for (const auto& check : comparison["checks"]) {
+      if (check["regression"].asBool()) {
+        std::cerr << "regression: " << check["name"].asString() << " "
+                  << check["metric"].asString() << " " << check["baseline"].asDouble() << " -> "
+                  << check["current"].asDouble() << "\n";
+      }
+    }
+    status = comparison["regressions"].asUInt64() > 0 ? 3 : 0;
+    report["comparison"] = std::move(comparison);
+  }
+  return bench::WriteReport(report, args.Get("json")) ? status : 1;
+}
+
+int RunGenerate(const Args& args) {
+  if (!args.Has("workspace")) {
+    std::cerr << "generate needs --workspace <dir>\n" << kUsage;
+    return 2;
+  }
+  const Workload workload(args);
+  auto report = bench::NewReport("generate", workload.Config());
+  return bench::WriteReport(report, args.Get("json")) ? 0 : 1;
+}
+
+int RunMicro(const Args& args) {
+  const Workload workload(args);
+  if (workload.products.empty()) {
+    std::cerr << "No products under " << workload.productsRoot << "\n";
+    return 1;
+  }
+  const auto product = args.Get("product", workload.products.front());
+  const auto iterations = std::max<size_t>(args.GetSize("iterations", 20), 1);
+  const auto loadIterations = std::max<size_t>(args.GetSize("load-iterations", 5), 1);
+  const auto warmup = args.GetSize("warmup", 2);
+  const auto serviceOptions = ResolveServiceOptions(args);
+
+  auto config = workload.Config();
+  config["product"] = product;
+  config["iterations"] = static_cast<Json::UInt64>(iterations);
+  config["load_iterations"] = static_cast<Json::UInt64>(loadIterations);
+  config["load_threads"] = static_cast<Json::UInt64>(serviceOptions.loadThreads);
+  config["lazy_content"] = serviceOptions.lazyContent;
+  config["hardware_threads"] = std::thread::hardware_concurrency();
+  auto report = bench::NewReport("micro", config);
+  auto& results = report["results"];
+
+  // Parsing: the item files of the product, already in memory.
+  std::vector<std::string> contents;
+  std::uintmax_t contentBytes = 0;
+  const auto itemsRoot = workload.productsRoot / product / "items";
+  if (std::filesystem::exists(itemsRoot)) {
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(itemsRoot)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".md") {
+        contents.push_back(ReadFile(entry.path()));
+        contentBytes += contents.back().size();
+      }
+    }
+  }
+  report["config"]["item_files"] = static_cast<Json::UInt64>(contents.size());
+
+  std::array<std::string, 7> values;
+  const std::array<webview::frontmatter::Field, 7> fields = {{{"id", &values[0]},
+                                                              {"type", &values[1]},
+                                                              {"title", &values[2]},
+                                                              {"state", &values[3]},
+                                                              {"parent", &values[4]},
+                                                              {"created", &values[5]},
+                                                              {"updated", &values[6]}}};
+  size_t parsed = 0;
+  std::string error;
+  auto parse = bench::Measure("parse.frontmatter", warmup, iterations, [&] {
+    for (const auto& content : contents) {
+      parsed += webview::frontmatter::Parse(content, fields, error) ? 1 : 0;
+    }
+  });
+  AddThroughput(parse, contentBytes);
+  parse["files"] = static_cast<Json::UInt64>(contents.size());
+  results.append(std::move(parse));
+
+  size_t found = 0;
+  auto scan = bench::Measure("strings.find_ignore_case", warmup, iterations, [&] {
+    for (const auto& content : contents) {
+      found += webview::text::FindIgnoreCase(content, "Snapshot Latency") != std::string::npos;
+    }
+  });
+  AddThroughput(scan, contentBytes);
+  results.append(std::move(scan));
+
+  // Loading: a fresh service per cold run, then one kept for the rest.
+  std::string probeId;
+  results.append(bench::Measure("load.cold", 0, loadIterations, [&] {
+    webview::BacklogWebviewService service(workload.productsRoot, serviceOptions);
+    probeId = FirstItemId(service, product);
+  }));
+
+  webview::BacklogWebviewService service(workload.productsRoot, serviceOptions);
+  probeId = FirstItemId(service, product);
+  if (probeId.empty()) {
+    std::cerr << "Product " << product << " has no items\n";
+    return 1;
+  }
+  results.append(bench::Measure("load.refresh", 1, loadIterations, [&] {
+    service.Refresh(product);
+    service.GetItem(product, probeId);
+  }));
+
+  if (workload.generated && !workload.generated->sampleItemPath.empty()) {
+    // Edit one file and wait for the snapshot to move: watcher delivery
+    // plus an incremental reload.
+    const auto path = workload.generated->sampleItemPath;
+    size_t edits = 0;
+    size_t timeouts = 0;
+    auto etag = service.GetSerializedView(product, webview::BacklogWebviewService::View::Tree).etag;
+    auto incremental = bench::Measure("load.incremental", 1, loadIterations, [&] {
+      std::ofstream(path, std::ios::app) << "\nEdit " << ++edits << ".\n";
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (std::chrono::steady_clock::now() < deadline) {
+        const auto next =
+            service.GetSerializedView(product, webview::BacklogWebviewService::View::Tree).etag;
+        if (next != etag) {
+          etag = next;
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      ++timeouts;
+    });
+    incremental["timeouts"] = static_cast<Json::UInt64>(timeouts);
+    results.append(std::move(incremental));
+  }
+
+  // Serialization. The streamed items writer and tree/children bypass the
+  // per-snapshot memo; the DOM paths build and write a jsoncpp tree.
+  std::uintmax_t streamed = 0;
+  auto items = bench::Measure("serialize.items", warmup, iterations, [&] {
+    const auto reader = service.StreamItems(product, {}, webview::BacklogWebviewService::StreamFormat::Json);
+    std::vector<char> buffer(64 * 1024);
+    streamed = 0;
+    while (const auto size = reader(buffer.data(), buffer.size())) {
+      streamed += size;
+    }
+  });
+  AddThroughput(items, streamed);
+  results.append(std::move(items));
+
+  results.append(bench::Measure("serialize.items.memo", warmup, iterations, [&] {
+    service.GetSerializedView(product, webview::BacklogWebviewService::View::Items);
+  }));
+
+  std::uintmax_t treeBytes = 0;
+  auto tree = bench::Measure("serialize.tree", warmup, iterations, [&] {
+    treeBytes = service.GetTreeChildren(product, "", 0).data->size();
+  });
+  AddThroughput(tree, treeBytes);
+  results.append(std::move(tree));
+
+  results.append(bench::Measure("serialize.tree.children", warmup, iterations, [&] {
+    service.GetTreeChildren(product, "", 1);
+  }));
+
+  results.append(bench::Measure("dom.items", warmup, iterations, [&] {
+    WriteCompact(service.ListItems(product));
+  }));
+  results.append(bench::Measure("dom.tree", warmup, iterations, [&] {
+    WriteCompact(service.BuildTree(product));
+  }));
+  results.append(bench::Measure("dom.kanban", warmup, iterations, [&] {
+    WriteCompact(service.BuildKanban(product));
+  }));
+
+  // Distinct limits keep each query off the memo.
+  size_t searches = 0;
+  results.append(bench::Measure("search.items", warmup, iterations, [&] {
+    webview::ItemQuery query;
+    query.text = searches % 2 == 0 ? "snapshot" : "cache";
+    query.limit = 50 + searches++;
+    service.GetSerializedView(product, webview::BacklogWebviewService::View::Items, query);
+  }));
+
+  results.append(bench::Measure("item.detail", warmup, iterations, [&] {
+    service.GetItem(product, probeId);
+  }));
+
+  report["config"]["checksum"] = static_cast<Json::UInt64>(parsed + found);
+  report["peak_rss_bytes"] = static_cast<Json::UInt64>(bench::PeakRssBytes());
+  return FinishReport(report, args);
+}
+
+// The endpoints --mix picks from; all of them, once each, by default.
+std::vector<bench::HttpTarget> MixTargets(const std::string& product) {
+  const auto query = "?product=" + product;
+  return {
+      {"items", "/api/items" + query},
+      {"search", "/api/items" + query + "&q=cache&limit=50"},
+      {"tree", "/api/tree" + query},
+      {"tree.children", "/api/tree/children" + query + "&depth=1"},
+      {"kanban", "/api/kanban" + query},
+      {"kanban.lane", "/api/kanban" + query + "&lane=Backlog&limit=50&fields=title,type,state"},
+      {"detail", "/api/items/{id}" + query},
+  };
+}
+
+// --target paths as given, else the mix: "--mix items=4,detail=2" keeps the
+// listed endpoints with those weights (a bare name weighs 1).
+std::vector<bench::HttpTarget> ResolveTargets(const Args& args, const std::string& product) {
+  std::vector<bench::HttpTarget> targets;
+  for (const auto& path : args.GetAll("target")) {
+    targets.push_back({path, path, 1});
+  }
+  if (!targets.empty() || !args.Has("mix")) {
+    return targets.empty() ? MixTargets(product) : targets;
+  }
+  const auto mix = MixTargets(product);
+  const auto spec = args.Get("mix");
+  size_t cursor = 0;
+  while (cursor <= spec.size()) {
+    const auto end = std::min(spec.find(',', cursor), spec.size());
+    const auto entry = spec.substr(cursor, end - cursor);
+    cursor = end + 1;
+    if (entry.empty()) {
+      continue;
+    }
+    const auto equals = entry.find('=');
+    const auto name = entry.substr(0, equals);
+    const auto it = std::find_if(mix.begin(), mix.end(),
+                                 [&](const bench::HttpTarget& target) { return target.name == name; });
+    if (it == mix.end()) {
+      throw std::invalid_argument("Unknown --mix endpoint: " + name);
+    }
+    auto target = *it;
+    target.weight = equals == std::string::npos ? 1 : std::stoull(entry.substr(equals + 1));
+    targets.push_back(std::move(target));
+  }
+  return targets;
+}
+
+void AddTargetsConfig(Json::Value& config, const bench::HttpLoadOptions& load) {
+  config["connections"] = static_cast<Json::UInt64>(load.connections);
+  config["item_ids"] = static_cast<Json::UInt64>(load.itemIds.size());
+  config["targets"] = Json::Value(Json::arrayValue);
+  for (const auto& target : load.targets) {
+    Json::Value entry(Json::objectValue);
+    entry["name"] = target.name;
+    entry["path"] = target.path;
+    entry["weight"] = static_cast<Json::UInt64>(target.weight);
+    config["targets"].append(std::move(entry));
+  }
+}
+
+bool NeedsItemIds(const bench::HttpLoadOptions& load) {
+  return std::any_of(load.targets.begin(), load.targets.end(), [](const bench::HttpTarget& target) {
+    return target.weight > 0 && target.path.find("{id}") != std::string::npos;
+  });
+}
+
+int RunHttp(const Args& args) {
+  bench::HttpLoadOptions load;
+  load.connections = std::max<size_t>(args.GetSize("connections", 8), 1);
+  load.duration = std::chrono::milliseconds(
+      static_cast<std::int64_t>(args.GetDouble("duration-s", 10.0) * 1000.0));
+  load.warmup = std::chrono::milliseconds(
+      static_cast<std::int64_t>(args.GetDouble("warmup-s", 1.0) * 1000.0));
+  const auto idCount = std::max<size_t>(args.GetSize("ids", 256), 1);
+
+  Json::Value config(Json::objectValue);
+  if (args.Has("url")) {
+    // Against a running server; nothing is generated or hosted, and the
+    // server's memory is its own, so no peak RSS is reported.
+    load.baseUrl = args.Get("url");
+    if (!args.Has("product") && !args.Has("target")) {
+      std::cerr << "http --url needs --product or --target\n" << kUsage;
+      return 2;
+    }
+    load.targets = ResolveTargets(args, args.Get("product"));
+    if (NeedsItemIds(load)) {
+      load.itemIds = bench::FetchItemIds(load.baseUrl, args.Get("product"), idCount);
+    }
+    config["url"] = load.baseUrl;
+    config["product"] = args.Get("product");
+    AddTargetsConfig(config, load);
+    auto report = bench::NewReport("http", config);
+    report["results"] = bench::RunHttpLoad(load);
+    return FinishReport(report, args);
+  }
+
+  const Workload workload(args);
+  if (workload.products.empty()) {
+    std::cerr << "No products under " << workload.productsRoot << "\n";
+    return 1;
+  }
+  const auto product = args.Get("product", workload.products.front());
+  const auto port = static_cast<uint16_t>(args.GetSize("port", 18787));
+  const auto threads = args.GetSize("threads", 0);
+
+  webview::BacklogWebviewService service(workload.productsRoot, ResolveServiceOptions(args));
+  load.targets = ResolveTargets(args, product);
+  if (NeedsItemIds(load)) {
+    load.itemIds = ItemIds(service, product, idCount);
+    if (load.itemIds.empty()) {
+      std::cerr << "Product " << product << " has no items\n";
+      return 1;
+    }
+  }
+  load.baseUrl = "http://127.0.0.1:" + std::to_string(port);
+
+  auto appendMeta = [&](const drogon::HttpRequestPtr&, Json::Value& body) {
+    body["meta"]["products_root"] = service.GetProductsRoot().generic_string();
+  };
+  webview::RegisterBacklogWebviewRoutes(service, appendMeta);
+
+  config = workload.Config();
+  config["url"] = load.baseUrl;
+  config["product"] = product;
+  config["server_threads"] = static_cast<Json::UInt64>(threads);
+  AddTargetsConfig(config, load);
+  auto report = bench::NewReport("http", config);
+
+  // The driver runs beside the server's loops and stops the app when done.
+  std::thread driver;
+  drogon::app().registerBeginningAdvice([&] {
+    driver = std::thread([&] {
+      report["results"] = bench::RunHttpLoad(load);
+      drogon::app().quit();
+    });
+  });
+  drogon::app().setLogLevel(trantor::Logger::kWarn);
+  drogon::app().setThreadNum(threads);
+  drogon::app().addListener("127.0.0.1", port);
+  drogon::app().run();
+  if (driver.joinable()) {
+    driver.join();
+  }
+  // Server and driver share the process, so this covers both.
+  report["peak_rss_bytes"] = static_cast<Json::UInt64>(bench::PeakRssBytes());
+  return FinishReport(report, args);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << kUsage;
+    return 2;
+  }
+  const std::string mode = argv[1];
+  try {
+    const Args args(argc, argv, 2);
+    if (mode == "generate") {
+      return RunGenerate(args);
+    }
+    if (mode == "micro") {
+      return RunMicro(args);
+    }
+    if (mode == "http") {
+      return RunHttp(args);
+    }
+  } catch (const std::exception& error) {
+    std::cerr << "kano_backlog_webview_bench: " << error.what() << "\n";
+    return 1;
+  }
+  std::cerr << kUsage;
+  return 2;
+}
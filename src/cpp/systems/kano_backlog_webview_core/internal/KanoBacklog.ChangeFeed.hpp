@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace kano::backlog::webview {
+
+// Fans per-product change frames out to long-lived subscribers (SSE
+// streams). One background thread, started on the first subscription,
+// polls every product that has subscribers and is the only caller of the
+// poll, release and sink callbacks, so they need no locking of their own.
+// Idle subscribers get a keep-alive comment so closed connections are
+// noticed and dropped.
+class ChangeFeed {
+ public:
+  struct Frames {
+    // Broadcast to subscribers already greeted; empty when nothing changed.
+    std::string changes;
+    // Sent once to subscribers that joined since the previous poll.
+    std::string hello;
+  };
+  // greet asks for Frames::hello.
+  using Poll = std::function<Frames(const std::string& product, bool greet)>;
+  // The product lost its last subscriber; per-product poll state can go.
+  using Release = std::function<void(const std::string& product)>;
+  // Returns false once the subscriber is gone; it is then dropped.
+  using Sink = std::function<bool(const std::string& frame)>;
+
+  ChangeFeed(Poll poll, Release release, std::chrono::milliseconds interval,
+             std::chrono::milliseconds keepAlive);
+  ~ChangeFeed();
+
+  ChangeFeed(const ChangeFeed&) = delete;
+  ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+  std::uint64_t Subscribe(std::string product, Sink sink);
+  void Unsubscribe(std::uint64_t subscription);
+  size_t SubscriberCount() const;
+  // Joins the thread; no callback runs afterwards. Later subscriptions are
+  // kept but never polled.
+  void Stop();
+
+ private:
+  struct Subscriber {
+    std::string product;
+    Sink sink;
+    // Feed thread only.
+    bool greeted = false;
+  };
+
+  void Run();
+
+  const Poll poll;
+  const Release release;
+  const std::chrono::milliseconds interval;
+  const std::chrono::milliseconds keepAlive;
+
+  mutable std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  bool joined = false;
+  std::uint64_t nextId = 1;
+  std::map<std::uint64_t, std::shared_ptr<Subscriber>> subscribers;
+  // Products polled at least once and not yet released. Feed thread only.
+  std::set<std::string> polled;
+  std::thread thread;
+};
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace kano::backlog::webview {
+
+// Bounded LRU of file bodies read on demand when the product caches do not
+// keep item content resident. Entries are revalidated against the file's
+// mtime and size on every read, so a stale body is never served.
+class ContentCache {
+ public:
+  // capacityBytes 0 disables caching; every read goes to disk.
+  explicit ContentCache(size_t capacityBytes);
+
+  ContentCache(const ContentCache&) = delete;
+  ContentCache& operator=(const ContentCache&) = delete;
+
+  // Returns nullptr when the file cannot be read.
+  std::shared_ptr<const std::string> Read(const std::filesystem::path& path);
+
+  void Clear();
+
+  size_t CapacityBytes() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
+    std::shared_ptr<const std::string> text;
+  };
+
+  void Insert(Entry entry);
+
+  const size_t capacityBytes;
+  std::mutex mutex;
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> byKey;
+  size_t residentBytes = 0;
+};
+
+}  // namespace kano::backlog::webview
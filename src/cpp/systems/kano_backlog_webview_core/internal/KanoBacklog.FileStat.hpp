@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace kano::backlog::webview {
+
+struct FileStat {
+  std::filesystem::file_time_type mtime;
+  std::uintmax_t size = 0;
+};
+
+// Modification time and size of a regular file from one stat call
+// (GetFileAttributesExW on Windows), where last_write_time plus file_size
+// take two. The time matches std::filesystem::last_write_time. False when
+// the path is missing or not a regular file.
+bool StatFile(const std::filesystem::path& path, FileStat& stat);
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kano::backlog::webview {
+
+// Keeps one dirty flag per watched key (a product root path) so cache-hit requests
+// can skip the directory walk. Uses inotify on Linux and ReadDirectoryChangesW
+// on Windows; roots that cannot be watched natively (other platforms, watch
+// limits) are covered by a background polling thread instead.
+class FileWatcher {
+ public:
+  using TrackedFilter = std::function<bool(const std::filesystem::path&)>;
+
+  struct Delta {
+    bool dirty = false;
+    // The path list is incomplete (directory event, overflow, polling);
+    // callers must reconcile against a full listing.
+    bool rescan = false;
+    std::vector<std::filesystem::path> paths;
+  };
+
+  explicit FileWatcher(TrackedFilter isTracked);
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  // Registers the roots for key (idempotent). Pending changes are kept, even
+  // when the roots change; only ConsumeChanges clears them, so an event that
+  // lands between ConsumeChanges and Arm is not lost. Polled roots take the
+  // current tree as their new baseline. Call before reading the files so
+  // changes made during a load are not lost.
+  void Arm(const std::string& key, const std::vector<std::filesystem::path>& roots);
+
+  // Cheap check used on the request path; does not clear anything.
+  bool HasChanges(const std::string& key) const;
+
+  // Returns what changed under the key's roots since the last Arm/ConsumeChanges
+  // call and clears it. Unknown keys report a dirty rescan.
+  Delta ConsumeChanges(const std::string& key);
+
+  // Drops these keys, and the native watches no remaining key uses (the
+  // previous workspace's, once a switch has swapped in the new one).
+  void Forget(const std::vector<std::string>& keys);
+  // Drops every key and native watch.
+  void Clear();
+
+  std::string BackendName() const;
+
+  struct State;
+
+ private:
+  std::unique_ptr<State> state;
+};
+
+}  // namespace kano::backlog::webview
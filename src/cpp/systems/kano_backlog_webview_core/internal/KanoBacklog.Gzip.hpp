@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace kano::backlog::webview {
+
+// A gzip stream cut after a sync flush: the header and deflate blocks of a
+// known head, plus the head's CRC-32 and length. GzipFinish closes it with
+// any tail as stored blocks, so a per-request suffix (the response envelope)
+// never forces the head to be compressed again.
+struct GzipPrefix {
+  std::string bytes;
+  std::uint32_t crc = 0;
+  std::uint64_t size = 0;
+};
+
+// Complete gzip member of data.
+std::string GzipCompress(std::string_view data);
+GzipPrefix GzipCompressPrefix(std::string_view head);
+std::string GzipFinish(const GzipPrefix& prefix, std::string_view tail);
+
+// True when an Accept-Encoding value allows gzip (or *) with a nonzero q.
+bool AcceptsGzip(std::string_view acceptEncoding);
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace kano::backlog::webview {
+
+// Minimal codec for the on-disk index snapshots: fixed-width native-endian
+// integers and length-prefixed strings behind a magic/version header. The
+// files are a local cache, so any mismatch just means "rebuild".
+class IndexWriter {
+ public:
+  IndexWriter(std::string_view magic, std::uint32_t version);
+
+  void U8(std::uint8_t value);
+  void U32(std::uint32_t value);
+  void U64(std::uint64_t value);
+  void I64(std::int64_t value);
+  void String(std::string_view value);
+
+  // Writes to a sibling temp file and renames it over path, so readers never
+  // see a partial index. Returns false on any I/O error.
+  bool Commit(const std::filesystem::path& path) const;
+
+ private:
+  std::string buffer;
+};
+
+class IndexReader {
+ public:
+  // Reads the whole file; Ok() is false when it is missing or the header
+  // does not match.
+  IndexReader(const std::filesystem::path& path, std::string_view magic,
+              std::uint32_t version);
+
+  bool Ok() const;
+
+  // Each accessor returns false (and latches !Ok()) past the end of data.
+  bool U8(std::uint8_t& value);
+  bool U32(std::uint32_t& value);
+  bool U64(std::uint64_t& value);
+  bool I64(std::int64_t& value);
+  bool String(std::string& value);
+
+  bool AtEnd() const;
+
+ private:
+  bool Take(void* out, size_t size);
+
+  std::string buffer;
+  size_t cursor = 0;
+  bool ok = false;
+};
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kano::backlog::webview {
+
+// Threads for request work that blocks on the file system (product loads,
+// lazy body reads), so HTTP event loops only ever serve from memory. Jobs
+// run in arrival order; threads are started on demand up to the limit.
+class LoadExecutor {
+ public:
+  using Job = std::function<void()>;
+
+  // threadCount 0 is treated as 1.
+  explicit LoadExecutor(size_t threadCount);
+  // Runs the queued jobs out before joining.
+  ~LoadExecutor();
+
+  LoadExecutor(const LoadExecutor&) = delete;
+  LoadExecutor& operator=(const LoadExecutor&) = delete;
+
+  size_t Size() const { return threadCount; }
+  // Jobs queued and not yet started.
+  size_t Pending() const;
+
+  // A job that throws is dropped; jobs that owe a reply catch for themselves.
+  void Post(Job job);
+
+ private:
+  void Run();
+
+  const size_t threadCount;
+  mutable std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  size_t idle = 0;
+  std::deque<Job> queue;
+  std::vector<std::thread> threads;
+};
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+namespace kano::backlog::webview {
+
+// Fixed-bucket latency histogram; Observe is a few relaxed atomic adds.
+class LatencyHistogram {
+ public:
+  void Observe(std::chrono::nanoseconds elapsed);
+  // Appends the _bucket, _sum and _count series in the Prometheus text format.
+  void Render(std::string& out, std::string_view name, std::string_view labels) const;
+
+ private:
+  // Upper bounds in nanoseconds, 100 us to 10 s.
+  static constexpr std::array<std::uint64_t, 16> kBounds = {
+      100'000,     250'000,     500'000,       1'000'000,     2'500'000,     5'000'000,
+      10'000'000,  25'000'000,  50'000'000,    100'000'000,   250'000'000,   500'000'000,
+      1'000'000'000, 2'500'000'000, 5'000'000'000, 10'000'000'000};
+
+  // Per-bucket (not cumulative) counts; the last one is +Inf.
+  std::array<std::atomic<std::uint64_t>, kBounds.size() + 1> buckets{};
+  std::atomic<std::uint64_t> sumNanos{0};
+};
+
+// Counters for one product's loader and views. Products are keyed by name,
+// so a workspace switch keeps counting into the same series.
+struct ProductMetrics {
+  // Finding what changed: the full enumeration on a rescan, or resolving
+  // the watcher's changed paths.
+  LatencyHistogram scan;
+  // LoadProduct calls that published a snapshot.
+  LatencyHistogram load;
+  // View bodies built on a memo miss (and tree children, which are not memoized).
+  LatencyHistogram serialize;
+  std::atomic<std::uint64_t> filesParsed{0};
+  std::atomic<std::uint64_t> snapshotHits{0};
+  std::atomic<std::uint64_t> snapshotMisses{0};
+  std::atomic<std::uint64_t> viewHits{0};
+  std::atomic<std::uint64_t> viewMisses{0};
+  std::atomic<std::uint64_t> bytesSerialized{0};
+  // Primary ids in the last published snapshot.
+  std::atomic<std::uint64_t> items{0};
+  // Its estimated size without the view memo (ProductCache::bytes).
+  std::atomic<std::uint64_t> snapshotBytes{0};
+};
+
+struct RouteMetrics {
+  // Handler time up to the response callback; for streamed responses that
+  // is time to headers.
+  LatencyHistogram latency;
+  // Responses by status class, 1xx to 5xx.
+  std::array<std::atomic<std::uint64_t>, 5> responses{};
+};
+
+// Process-lifetime registry behind /metrics. Series are created on first
+// use and never removed; the returned references stay valid for the
+// registry's lifetime, so callers may cache them.
+class Metrics {
+ public:
+  ProductMetrics& Product(std::string_view product);
+  RouteMetrics& Route(std::string_view route);
+
+  // Appends every series in the Prometheus text exposition format.
+  void Render(std::string& out) const;
+
+ private:
+  template <typename T>
+  static T& Find(std::shared_mutex& mutex,
+                 std::map<std::string, std::unique_ptr<T>, std::less<>>& series,
+                 std::string_view key);
+
+  mutable std::shared_mutex productMutex;
+  std::map<std::string, std::unique_ptr<ProductMetrics>, std::less<>> products;
+  mutable std::shared_mutex routeMutex;
+  std::map<std::string, std::unique_ptr<RouteMetrics>, std::less<>> routes;
+};
+
+// Wall time of a scope, observed into a histogram on destruction.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(LatencyHistogram& histogram)
+      : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() { histogram.Observe(std::chrono::steady_clock::now() - start); }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  LatencyHistogram& histogram;
+  const std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace kano::backlog::webview {
+
+// Trigram postings over ASCII-lowered text. Candidates() is a superset of
+// the documents containing a needle of three or more characters; callers
+// verify hits against the text.
+class TrigramPostings {
+ public:
+  void Add(std::uint32_t doc, std::string_view loweredText);
+  // Sorts and dedups the posting lists; call once after the last Add.
+  void Finalize();
+
+  std::vector<std::uint32_t> Candidates(std::string_view loweredNeedle) const;
+
+  static bool Indexable(std::string_view needle) { return needle.size() >= 3; }
+
+ private:
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings;
+};
+
+// Case-insensitive id/title search for one product snapshot. Keeps lowered
+// copies so hits are exact; queries shorter than a trigram scan those
+// copies instead of the postings. Results are ranked: exact id, id prefix,
+// title prefix, title word start, id substring, title substring, then body
+// match, with ties broken by id.
+class SearchIndex {
+ public:
+  // Documents are numbered in insertion order; key is what Search returns.
+  void Add(size_t key, std::string_view id, std::string_view title);
+  void Finalize();
+
+  size_t Size() const { return keys.size(); }
+  size_t Key(std::uint32_t doc) const { return keys[doc]; }
+
+  struct Options {
+    // Keep only the best limit hits; 0 keeps all of them.
+    size_t limit = 0;
+    // Drops documents by key before ranking; empty accepts everything.
+    std::function<bool(size_t key)> accept;
+    // Same document numbering; extends matching to bodies for indexable
+    // queries, with bodyContains verifying each body candidate.
+    const TrigramPostings* bodies = nullptr;
+    std::function<bool(std::uint32_t doc, std::string_view loweredQuery)> bodyContains;
+  };
+
+  struct Result {
+    std::vector<size_t> keys;
+    // Accepted matches before the limit.
+    size_t total = 0;
+  };
+
+  Result Search(std::string_view query, const Options& options) const;
+
+ private:
+  int Score(std::uint32_t doc, std::string_view loweredQuery) const;
+
+  std::vector<size_t> keys;
+  std::vector<std::string> ids;
+  std::vector<std::string> titles;
+  TrigramPostings postings;
+};
+
+}  // namespace kano::backlog::webview
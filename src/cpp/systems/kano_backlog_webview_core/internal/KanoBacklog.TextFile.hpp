@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace kano::backlog::webview {
+
+// Reads into content, reusing its capacity. content is left empty on failure.
+// Eager parses and lazy body reads both go through here, so a body read on
+// demand matches the one a full load would have kept.
+bool ReadTextFile(const std::filesystem::path& path, std::string& content, std::string& error);
+
+}  // namespace kano::backlog::webview
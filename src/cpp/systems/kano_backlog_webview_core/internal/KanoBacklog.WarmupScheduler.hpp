@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+namespace kano::backlog::webview {
+
+// Runs background warm-up jobs one at a time on a thread started by the
+// first Schedule. Scheduling asks the running and queued jobs to stop, so
+// only the latest one does real work; stopped jobs still run and are
+// expected to return early (reporting that they were superseded).
+class WarmupScheduler {
+ public:
+  using Job = std::function<void(std::stop_token stop)>;
+
+  WarmupScheduler() = default;
+  // Stops every job and runs the queued ones out before joining.
+  ~WarmupScheduler();
+
+  WarmupScheduler(const WarmupScheduler&) = delete;
+  WarmupScheduler& operator=(const WarmupScheduler&) = delete;
+
+  void Schedule(Job job);
+
+ private:
+  struct Entry {
+    Job job;
+    std::stop_source stop;
+  };
+
+  void Run();
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  std::deque<Entry> queue;
+  std::stop_source running{std::nostopstate};
+  std::thread thread;
+};
+
+}  // namespace kano::backlog::webview
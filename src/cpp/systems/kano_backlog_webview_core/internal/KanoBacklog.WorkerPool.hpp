@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kano::backlog::webview {
+
+// Fixed set of worker threads for fan-out/fan-in work such as parsing the
+// files of a product. The calling thread takes part in its own batch, so a
+// pool of size 1 runs everything inline.
+class WorkerPool {
+ public:
+  // threadCount 0 selects std::thread::hardware_concurrency().
+  explicit WorkerPool(size_t threadCount);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  size_t Size() const;
+
+  // Runs body(i) for every i in [0, count) and returns once all calls have
+  // finished. The first exception thrown by body is rethrown here.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+ private:
+  struct Batch;
+
+  void RunWorker();
+  static void Drain(Batch& batch);
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  bool stopping = false;
+  std::deque<std::shared_ptr<Batch>> batches;
+  std::vector<std::thread> threads;
+};
+
+}  // namespace kano::backlog::webview
@@ -1,13 +1,33 @@
 #include "KanoBacklog.BacklogWebviewService.hpp"
 
+#include "KanoBacklog.ChangeFeed.hpp"
+#include "KanoBacklog.ContentCache.hpp"
+#include "KanoBacklog.FileStat.hpp"
+#include "KanoBacklog.FileWatcher.hpp"
+#include "KanoBacklog.Gzip.hpp"
+#include "KanoBacklog.IndexFile.hpp"
+#include "KanoBacklog.LoadExecutor.hpp"
+#include "KanoBacklog.Metrics.hpp"
+#include "KanoBacklog.SearchIndex.hpp"
+#include "KanoBacklog.TextFile.hpp"
+#include "KanoBacklog.WarmupScheduler.hpp"
+#include "KanoBacklog.WorkerPool.hpp"
+
 #include <algorithm>
+#include <charconv>
 #include <chrono>
-#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <future>
 #include <optional>
 #include <regex>
 #include <set>
-#include <sstream>
+#include <string_view>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
 
+import KanoBacklogWebview.Frontmatter;
 import KanoBacklogWebview.Strings;
 
 namespace kano::backlog::webview {
@@ -23,61 +43,512 @@ std::string Trim(const std::string& value) {
   return value.substr(first, last - first + 1);
 }
 
-std::string Unquote(const std::string& value) {
-  const auto trimmed = Trim(value);
-  if (trimmed.size() >= 2) {
-    const char first = trimmed.front();
-    const char last = trimmed.back();
-    if ((first == '"' && last == '"') || (first == '\'' && last == '\'')) {
-      return trimmed.substr(1, trimmed.size() - 2);
+// Finds or inserts the entry for id, building a key in the map's arena
+// only on insert.
+template <typename Map>
+typename Map::mapped_type& IdEntry(Map& map, const std::string_view id) {
+  if (const auto it = map.find(id); it != map.end()) {
+    return it->second;
+  }
+  return map.try_emplace(typename Map::key_type(id, map.get_allocator())).first->second;
+}
+
+// Reserves arena space for copying a snapshot's id tables in one block:
+// roughly two hashed nodes, a slot list and bucket slots per id.
+constexpr size_t kArenaBytesPerId = 192;
+constexpr size_t kMinArenaBytes = 4096;
+
+// Workspaces kept after switching away, on top of the budget; each keeps
+// its watches armed.
+constexpr size_t kMaxParkedWorkspaces = 8;
+
+// The change feed checks subscribed products this often; a cache hit is a
+// watcher lookup, so the interval bounds push latency, not load.
+constexpr std::chrono::milliseconds kChangePollInterval{250};
+constexpr std::chrono::milliseconds kChangeKeepAlive{15000};
+// Larger diffs are sent as a reset so clients reload instead of patching.
+constexpr size_t kMaxChangeIds = 500;
+
+// Metrics series of the shared topics/worksets loader, and of product names
+// without a directory (so stray requests cannot add label values).
+constexpr std::string_view kWorkspaceSeries = "(workspace)";
+constexpr std::string_view kUnknownProductSeries = "(unknown)";
+
+// Lazy-mode read buffers bigger than this are released after use.
+constexpr size_t kMaxReusedBufferBytes = size_t{1} << 20;
+
+bool StartsWith(const std::string& value, const std::string& prefix) {
+  return value.rfind(prefix, 0) == 0;
+}
+
+// Caps memoized query variants per snapshot so arbitrary search strings
+// cannot grow a snapshot without bound.
+constexpr size_t kMaxMemoizedViews = 64;
+
+// Same settings drogon uses for newHttpJsonResponse bodies.
+std::string SerializeCompact(const Json::Value& value) {
+  static const auto builder = [] {
+    Json::StreamWriterBuilder writerBuilder;
+    writerBuilder["commentStyle"] = "None";
+    writerBuilder["indentation"] = "";
+    writerBuilder["emitUTF8"] = true;
+    return writerBuilder;
+  }();
+  return Json::writeString(builder, value);
+}
+
+// Wraps an already serialized "data" payload in the usual {data, meta, ok}
+// envelope. jsoncpp writes keys in sorted order, so splicing "data" first
+// produces the same bytes as serializing the whole envelope.
+// Spliced responses are this head, the view data, then the envelope's other
+// members.
+constexpr std::string_view kEnvelopeHead = "{\"data\":";
+
+// Smaller bodies are sent uncompressed; gzip would save little.
+constexpr size_t kMinGzipBytes = 1024;
+
+// gzip, when set, is the compressed head and data; only the envelope tail
+// is appended per request.
+drogon::HttpResponsePtr NewSplicedJsonResponse(
+    const drogon::HttpRequestPtr& request, const std::string& data, const bool ok,
+    const std::function<void(const drogon::HttpRequestPtr&, Json::Value&)>& metaAppender,
+    const GzipPrefix* gzip = nullptr) {
+  Json::Value envelope(Json::objectValue);
+  envelope["ok"] = ok;
+  metaAppender(request, envelope);
+  const auto rest = SerializeCompact(envelope);
+
+  auto response = drogon::HttpResponse::newHttpResponse();
+  response->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+  if (gzip) {
+    std::string tail = ",";
+    tail.append(rest, 1, std::string::npos);
+    response->setBody(GzipFinish(*gzip, tail));
+    response->addHeader("Content-Encoding", "gzip");
+  } else {
+    std::string body;
+    body.reserve(data.size() + rest.size() + 8);
+    body += kEnvelopeHead;
+    body += data;
+    body += ',';
+    body.append(rest, 1, std::string::npos);
+    response->setBody(std::move(body));
+  }
+  if (!ok) {
+    response->setStatusCode(drogon::k400BadRequest);
+  }
+  return response;
+}
+
+// Quoted JSON string with the escapes jsoncpp emits under emitUTF8, so
+// hand-written payloads match SerializeCompact byte for byte.
+void AppendJsonString(std::string& out, const std::string_view value) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  out.push_back('"');
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\b':
+        out += "\\b";
+        break;
+      case '\f':
+        out += "\\f";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out += "\\u00";
+          out.push_back(kHex[(c >> 4) & 0xF]);
+          out.push_back(kHex[c & 0xF]);
+        } else {
+          out.push_back(c);
+        }
     }
   }
-  return trimmed;
+  out.push_back('"');
 }
 
-std::string NormalizeNullToken(std::string value) {
-  const auto lowered = text::ToLower(Trim(value));
-  if (lowered == "null" || lowered == "none" || lowered == "~") {
-    return "";
+// Streamed payloads are produced in chunks of about this size.
+constexpr size_t kStreamChunkBytes = 16 * 1024;
+
+// Strong validator for one view of one snapshot generation. The query is
+// hashed (FNV-1a) to keep the header short.
+std::string ViewEtag(const std::uint64_t generation, const std::string& viewKey) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (const unsigned char c : viewKey) {
+    hash = (hash ^ c) * 1099511628211ull;
   }
-  return value;
+  char buffer[48];
+  std::snprintf(buffer, sizeof(buffer), "\"%llx-%llx\"",
+                static_cast<unsigned long long>(generation),
+                static_cast<unsigned long long>(hash));
+  return buffer;
 }
 
-std::vector<std::string> SplitLines(const std::string& text) {
-  std::vector<std::string> lines;
-  std::stringstream stream(text);
-  std::string line;
-  while (std::getline(stream, line)) {
-    lines.push_back(line);
+// If-None-Match uses weak comparison (RFC 9110 13.1.2), so W/ prefixes are
+// ignored.
+bool MatchesIfNoneMatch(const std::string& header, const std::string& etag) {
+  size_t start = 0;
+  while (start < header.size()) {
+    auto end = header.find(',', start);
+    if (end == std::string::npos) {
+      end = header.size();
+    }
+    auto candidate = Trim(header.substr(start, end - start));
+    if (StartsWith(candidate, "W/")) {
+      candidate.erase(0, 2);
+    }
+    if (candidate == "*" || candidate == etag) {
+      return true;
+    }
+    start = end + 1;
   }
-  return lines;
+  return false;
 }
 
-std::string ReadTextFile(const std::filesystem::path& path, bool& ok,
-                         std::string& error) {
-  ok = false;
-  error.clear();
-  std::ifstream input(path);
-  if (!input.is_open()) {
-    error = "Failed to open file";
-    return "";
+using ResponseCallback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+// Wraps a handler's callback so the time until it is called, and the status
+// it is called with, are recorded under route.
+ResponseCallback TimedCallback(BacklogWebviewService& service, const std::string_view route,
+                               ResponseCallback&& callback) {
+  return [&service, route, start = std::chrono::steady_clock::now(),
+          callback = std::move(callback)](const drogon::HttpResponsePtr& response) {
+    service.ObserveRequest(route, std::chrono::steady_clock::now() - start,
+                           static_cast<int>(response->getStatusCode()));
+    callback(response);
+  };
+}
+
+// Load executor job that answers with respond's response. Off the event
+// loop nothing else would answer a throw, so it gets a 500 here.
+std::function<void()> ReplyJob(ResponseCallback callback,
+                               std::function<drogon::HttpResponsePtr()> respond) {
+  return [callback = std::move(callback), respond = std::move(respond)] {
+    drogon::HttpResponsePtr response;
+    try {
+      response = respond();
+    } catch (const std::exception& error) {
+      Json::Value body(Json::objectValue);
+      body["ok"] = false;
+      body["data"]["error"] = std::string("Internal error: ") + error.what();
+      response = drogon::HttpResponse::newHttpJsonResponse(body);
+      response->setStatusCode(drogon::k500InternalServerError);
+    }
+    callback(response);
+  };
+}
+
+drogon::HttpResponsePtr NewViewResponse(
+    const drogon::HttpRequestPtr& request,
+    const BacklogWebviewService::SerializedView& view,
+    const std::function<void(const drogon::HttpRequestPtr&, Json::Value&)>& metaAppender) {
+  if (!view.ok) {
+    auto response = NewSplicedJsonResponse(request, *view.data, false, metaAppender);
+    if (view.notFound) {
+      response->setStatusCode(drogon::k404NotFound);
+    }
+    return response;
   }
-  std::stringstream buffer;
-  buffer << input.rdbuf();
-  ok = true;
-  return buffer.str();
+
+  drogon::HttpResponsePtr response;
+  if (MatchesIfNoneMatch(request->getHeader("if-none-match"), view.etag)) {
+    response = drogon::HttpResponse::newHttpResponse();
+    response->setStatusCode(drogon::k304NotModified);
+  } else {
+    response = NewSplicedJsonResponse(request, *view.data, true, metaAppender, view.gzip.get());
+  }
+  response->addHeader("ETag", view.etag);
+  response->addHeader("Vary", "Accept-Encoding");
+  // Always revalidate; a 304 costs a round trip but no payload.
+  response->addHeader("Cache-Control", "no-cache");
+  return response;
 }
 
-bool StartsWith(const std::string& value, const std::string& prefix) {
-  return value.rfind(prefix, 0) == 0;
+// Chunked response for a streamed view. Json wraps the reader's output in
+// the usual {"data":...,"meta":...,"ok":true} envelope; NdJson is sent bare.
+drogon::HttpResponsePtr NewStreamedResponse(
+    const drogon::HttpRequestPtr& request, BacklogWebviewService::StreamReader reader,
+    const BacklogWebviewService::StreamFormat format,
+    const std::function<void(const drogon::HttpRequestPtr&, Json::Value&)>& metaAppender) {
+  if (format == BacklogWebviewService::StreamFormat::NdJson) {
+    return drogon::HttpResponse::newStreamResponse(reader, "", drogon::CT_CUSTOM,
+                                                   "application/x-ndjson");
+  }
+
+  Json::Value envelope(Json::objectValue);
+  envelope["ok"] = true;
+  metaAppender(request, envelope);
+  std::string head = "{\"data\":";
+  std::string tail = "," + SerializeCompact(envelope).substr(1);
+  size_t headOffset = 0;
+  size_t tailOffset = 0;
+  bool bodyDone = false;
+  return drogon::HttpResponse::newStreamResponse(
+      [reader = std::move(reader), head = std::move(head), tail = std::move(tail), headOffset,
+       tailOffset, bodyDone](char* buffer, const std::size_t size) mutable -> std::size_t {
+        if (!buffer) {
+          return reader(nullptr, 0);
+        }
+        const auto copyFrom = [&](const std::string& part, size_t& offset) {
+          const auto count = std::min(size, part.size() - offset);
+          std::memcpy(buffer, part.data() + offset, count);
+          offset += count;
+          return count;
+        };
+        if (headOffset < head.size()) {
+          return copyFrom(head, headOffset);
+        }
+        if (!bodyDone) {
+          if (const auto count = reader(buffer, size); count > 0) {
+            return count;
+          }
+          bodyDone = true;
+        }
+        return copyFrom(tail, tailOffset);
+      },
+      "", drogon::CT_APPLICATION_JSON);
+}
+
+// Comma-separated request parameter; blanks are dropped.
+std::vector<std::string> SplitParameter(const std::string& value) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  while (start <= value.size()) {
+    const auto end = std::min(value.find(',', start), value.size());
+    auto part = Trim(value.substr(start, end - start));
+    if (!part.empty()) {
+      parts.push_back(std::move(part));
+    }
+    start = end + 1;
+  }
+  return parts;
+}
+
+// False unless all of value is a decimal count.
+bool ParseSize(const std::string& value, size_t& result) {
+  const auto* end = value.data() + value.size();
+  const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+  return !value.empty() && ec == std::errc() && ptr == end;
+}
+
+size_t SizeParameter(const std::string& value) {
+  size_t result = 0;
+  return ParseSize(value, result) ? result : 0;
+}
+
+ItemQuery ItemQueryFromRequest(const drogon::HttpRequestPtr& request) {
+  ItemQuery query;
+  query.text = request->getParameter("q");
+  query.searchBody = request->getParameter("body") == "1";
+  query.types = SplitParameter(request->getParameter("type"));
+  query.states = SplitParameter(request->getParameter("state"));
+  const auto& parameters = request->getParameters();
+  if (const auto parentIt = parameters.find("parent"); parentIt != parameters.end()) {
+    query.parent = parentIt->second;
+  }
+  query.cursor = request->getParameter("cursor");
+  query.offset = SizeParameter(request->getParameter("offset"));
+  query.limit = SizeParameter(request->getParameter("limit"));
+  query.fields = SplitParameter(request->getParameter("fields"));
+  query.countsOnly = request->getParameter("counts") == "1";
+  query.lane = request->getParameter("lane");
+  return query;
+}
+
+// Pre-order walk over hierarchy with an explicit stack. enter(node) runs
+// before a node's children, leave(node) after them. Nodes maxDepth levels
+// below a start are entered but not descended into (0 is unbounded).
+template <typename Hierarchy, typename Enter, typename Leave>
+void WalkHierarchy(const Hierarchy& hierarchy, const std::vector<std::uint32_t>& starts,
+                   const size_t maxDepth, const Enter& enter, const Leave& leave) {
+  struct Frame {
+    std::uint32_t node;
+    std::uint32_t nextChild;
+  };
+  std::vector<Frame> stack;
+  for (const auto start : starts) {
+    enter(start);
+    stack.push_back({start, hierarchy.childBegin[start]});
+    while (!stack.empty()) {
+      auto& frame = stack.back();
+      if (frame.nextChild == hierarchy.childBegin[frame.node + 1] ||
+          (maxDepth > 0 && stack.size() == maxDepth)) {
+        leave(frame.node);
+        stack.pop_back();
+        continue;
+      }
+      const auto child = hierarchy.children[frame.nextChild++];
+      enter(child);
+      stack.push_back({child, hierarchy.childBegin[child]});
+    }
+  }
+}
+
+// Bumped whenever the SaveIndex layout changes; old files are ignored.
+constexpr std::string_view kIndexMagic = "KBWIDX\r\n";
+constexpr std::uint32_t kIndexVersion = 1;
+
+std::int64_t TimeToInt(const std::filesystem::file_time_type value) {
+  return static_cast<std::int64_t>(value.time_since_epoch().count());
+}
+
+std::filesystem::file_time_type IntToTime(const std::int64_t value) {
+  return std::filesystem::file_time_type(std::filesystem::file_time_type::duration(value));
+}
+
+// Reads `digits` decimal digits at `at`, advancing past them.
+bool ReadDigits(const std::string_view text, size_t& at, const size_t digits, int& value) {
+  if (at + digits > text.size()) {
+    return false;
+  }
+  const auto* begin = text.data() + at;
+  const auto [end, error] = std::from_chars(begin, begin + digits, value);
+  if (error != std::errc() || end != begin + digits) {
+    return false;
+  }
+  at += digits;
+  return true;
+}
+
+// UTC milliseconds for `YYYY-MM-DD[(T| )hh:mm[:ss[.fff]]][Z|+hh[:mm]|-hh[:mm]]`,
+// or kNoTimestamp when the text does not have that shape.
+std::int64_t ParseTimestamp(const std::string_view text) {
+  using namespace std::chrono;
+  size_t at = 0;
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  const auto expect = [&](const char c) {
+    if (at < text.size() && text[at] == c) {
+      ++at;
+      return true;
+    }
+    return false;
+  };
+  if (!ReadDigits(text, at, 4, year) || !expect('-') || !ReadDigits(text, at, 2, month) ||
+      !expect('-') || !ReadDigits(text, at, 2, day)) {
+    return kNoTimestamp;
+  }
+  const year_month_day date{std::chrono::year(year), std::chrono::month(month),
+                            std::chrono::day(day)};
+  if (!date.ok()) {
+    return kNoTimestamp;
+  }
+  std::int64_t ms = duration_cast<milliseconds>(sys_days(date).time_since_epoch()).count();
+  if (at == text.size()) {
+    return ms;
+  }
+
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  if ((!expect('T') && !expect(' ')) || !ReadDigits(text, at, 2, hour) || !expect(':') ||
+      !ReadDigits(text, at, 2, minute) || hour > 23 || minute > 59) {
+    return kNoTimestamp;
+  }
+  if (expect(':')) {
+    if (!ReadDigits(text, at, 2, second) || second > 60) {
+      return kNoTimestamp;
+    }
+    if (expect('.')) {
+      // Milliseconds from the first three fraction digits.
+      int scale = 100;
+      const auto fractionStart = at;
+      while (at < text.size() && text[at] >= '0' && text[at] <= '9') {
+        ms += (text[at] - '0') * scale;
+        scale /= 10;
+        ++at;
+      }
+      if (at == fractionStart) {
+        return kNoTimestamp;
+      }
+    }
+  }
+  ms += ((hour * 60 + minute) * 60 + second) * std::int64_t{1000};
+  if (at == text.size() || expect('Z')) {
+    return at == text.size() ? ms : kNoTimestamp;
+  }
+
+  const bool ahead = text[at] == '+';
+  if (!expect('+') && !expect('-')) {
+    return kNoTimestamp;
+  }
+  int offsetHours = 0;
+  int offsetMinutes = 0;
+  if (!ReadDigits(text, at, 2, offsetHours) ||
+      (expect(':') ? !ReadDigits(text, at, 2, offsetMinutes)
+                   : at < text.size() && !ReadDigits(text, at, 2, offsetMinutes)) ||
+      at != text.size() || offsetHours > 23 || offsetMinutes > 59) {
+    return kNoTimestamp;
+  }
+  const std::int64_t offset = (offsetHours * 60 + offsetMinutes) * std::int64_t{60000};
+  return ahead ? ms - offset : ms + offset;
+}
+
+// Workspace roots are compared as paths (parked workspaces, switching to
+// the current one), so they are kept canonical.
+std::filesystem::path CanonicalRoot(std::filesystem::path root) {
+  std::error_code ec;
+  auto canonical = std::filesystem::weakly_canonical(root, ec);
+  return !ec && !canonical.empty() ? canonical : root;
 }
 
 }  // namespace
 
-BacklogWebviewService::BacklogWebviewService(std::filesystem::path productsRootPath)
-    : productsRoot(std::move(productsRootPath)) {}
+BacklogWebviewService::BacklogWebviewService(std::filesystem::path productsRootPath,
+                                             BacklogWebviewOptions serviceOptions)
+    : productsRoot(CanonicalRoot(std::move(productsRootPath))),
+      options(serviceOptions),
+      watcher(std::make_unique<FileWatcher>(&BacklogWebviewService::IsTrackedFile)),
+      loadPool(std::make_unique<WorkerPool>(options.loadThreads)),
+      contentCache(std::make_unique<ContentCache>(options.contentCacheBytes)),
+      metrics(std::make_unique<Metrics>()),
+      // Seeded from the wall clock so ETags from a previous process run
+      // never match a generation issued by this one.
+      generationCounter(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count())),
+      changeFeed(std::make_unique<ChangeFeed>(
+          [this](const std::string& product, const bool greet) {
+            ChangeFeed::Frames frames;
+            PollChanges(product, greet, frames.changes, frames.hello);
+            return frames;
+          },
+          [this](const std::string& product) { feedBaselines.erase(product); },
+          kChangePollInterval, kChangeKeepAlive)) {
+  warmup = std::make_unique<WarmupScheduler>();
+  loadExecutor = std::make_unique<LoadExecutor>(options.ioThreads);
+  if (options.warmOnStart) {
+    warmup->Schedule([this, products = ProductNames(productsRoot)](const std::stop_token stop) {
+      WarmProducts(products, stop);
+    });
+  }
+}
+
+BacklogWebviewService::~BacklogWebviewService() {
+  // The feed thread posts reloads and drained jobs may subscribe, so the
+  // feed stops first and is destroyed only after the executor has run out.
+  changeFeed->Stop();
+  loadExecutor.reset();
+}
 
 std::filesystem::path BacklogWebviewService::GetProductsRoot() const {
+  std::shared_lock lock(stateMutex);
   return productsRoot;
 }
 
@@ -86,9 +557,122 @@ bool BacklogWebviewService::IsValidProductName(const std::string& product) const
   return std::regex_match(product, productRegex);
 }
 
-std::filesystem::path BacklogWebviewService::ProductRoot(
+std::shared_ptr<const BacklogWebviewService::ProductCache> BacklogWebviewService::CurrentSnapshot(
     const std::string& product) const {
-  return productsRoot / product;
+  std::shared_ptr<ProductState> state;
+  std::shared_ptr<ProductState> shared;
+  {
+    std::shared_lock lock(stateMutex);
+    const auto it = productStates.find(product);
+    if (it == productStates.end() || !sharedState) {
+      return nullptr;
+    }
+    state = it->second;
+    shared = sharedState;
+  }
+  const auto sharedSnapshot = shared->Snapshot();
+  const auto snapshot = state->Snapshot();
+  const bool current = sharedSnapshot && snapshot &&
+                       snapshot->sharedGeneration == sharedSnapshot->generation &&
+                       !watcher->HasChanges(shared->watchKey) &&
+                       !watcher->HasChanges(state->watchKey);
+  return current ? snapshot : nullptr;
+}
+
+void BacklogWebviewService::RunLoaded(const std::string& product, const bool readsContent,
+                                      std::function<void()> job) {
+  // Invalid names are rejected before any lookup, so they cost nothing.
+  if (!IsValidProductName(product)) {
+    job();
+    return;
+  }
+  const auto current = CurrentSnapshot(product);
+  if (current && !(readsContent && current->contentOnDisk)) {
+    job();
+    return;
+  }
+  loadExecutor->Post(std::move(job));
+}
+
+void BacklogWebviewService::RunOnLoader(std::function<void()> job) {
+  loadExecutor->Post(std::move(job));
+}
+
+BacklogWebviewService::ProductCache::ProductCache()
+    : arena(std::make_unique<std::pmr::monotonic_buffer_resource>(kMinArenaBytes)),
+      idIndexes(arena.get()),
+      primaryById(arena.get()) {}
+
+BacklogWebviewService::ProductCache::ProductCache(const ProductCache& other)
+    : arena(std::make_unique<std::pmr::monotonic_buffer_resource>(std::max(
+          kMinArenaBytes, other.primaryById.size() * kArenaBytesPerId))),
+      allItems(other.allItems),
+      idIndexes(other.idIndexes, arena.get()),
+      primaryById(other.primaryById, arena.get()),
+      latestMtime(other.latestMtime),
+      warnings(other.warnings),
+      generation(other.generation),
+      sharedGeneration(other.sharedGeneration),
+      hierarchy(other.hierarchy),
+      kanban(other.kanban),
+      contentOnDisk(other.contentOnDisk),
+      views(other.views),
+      search(other.search) {}
+
+std::shared_ptr<const BacklogWebviewService::ProductCache>
+BacklogWebviewService::ProductState::Snapshot() const {
+  std::lock_guard lock(snapshotMutex);
+  return snapshot;
+}
+
+void BacklogWebviewService::ProductState::Publish(
+    std::shared_ptr<const ProductCache> next) {
+  std::lock_guard lock(snapshotMutex);
+  snapshot.swap(next);
+}
+
+std::shared_ptr<BacklogWebviewService::ProductState> BacklogWebviewService::StateFor(
+    const std::string& product) {
+  {
+    std::shared_lock lock(stateMutex);
+    const auto it = productStates.find(product);
+    if (it != productStates.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock lock(stateMutex);
+  auto& state = productStates[product];
+  if (!state) {
+    state = NewProductState(productsRoot, product);
+  }
+  return state;
+}
+
+std::shared_ptr<BacklogWebviewService::ProductState> BacklogWebviewService::NewProductState(
+    const std::filesystem::path& root, const std::string& product) const {
+  auto state = std::make_shared<ProductState>();
+  state->productRoot = root / product;
+  state->backlogRoot = root.parent_path();
+  // Keyed by path so a load still running for a previous workspace cannot
+  // re-arm the watch of a same-named product in the new one.
+  state->watchKey = SourceKey(state->productRoot);
+  std::error_code ec;
+  state->metrics = &metrics->Product(std::filesystem::is_directory(state->productRoot, ec)
+                                         ? std::string_view(product)
+                                         : kUnknownProductSeries);
+  return state;
+}
+
+std::shared_ptr<BacklogWebviewService::ProductState> BacklogWebviewService::NewSharedState(
+    const std::filesystem::path& root) const {
+  auto state = std::make_shared<ProductState>();
+  state->scope = SourceScope::Workspace;
+  state->backlogRoot = root.parent_path();
+  // Suffixed so it never collides with a product rooted at the same path.
+  state->watchKey = SourceKey(state->backlogRoot) + "#shared";
+  state->metrics = &metrics->Product(kWorkspaceSeries);
+  return state;
 }
 
 std::filesystem::path BacklogWebviewService::ResolveProductsPathFromInput(
@@ -117,75 +701,188 @@ std::filesystem::path BacklogWebviewService::ResolveProductsPathFromInput(
   return {};
 }
 
-std::filesystem::file_time_type BacklogWebviewService::ScanLatestMtime(
-    const std::filesystem::path& productRoot) const {
-  auto latest = std::filesystem::file_time_type::min();
-  const auto backlogRoot = productsRoot.parent_path();
-  const std::vector<std::filesystem::path> roots = {
-      productRoot / "items", productRoot / "decisions", backlogRoot / "topics",
-      backlogRoot / "worksets"};
+std::vector<std::filesystem::path> BacklogWebviewService::TrackedRoots(
+    const ProductState& state) {
+  if (state.scope == SourceScope::Workspace) {
+    return {state.backlogRoot / "topics", state.backlogRoot / "worksets"};
+  }
+  std::vector<std::filesystem::path> roots = {state.productRoot / "items",
+                                              state.productRoot / "decisions"};
+  // Only an existing config directory is watched, so products without one
+  // are not left to polling; a later one is seen on the next rescan.
+  std::error_code ec;
+  if (std::filesystem::is_directory(LaneMapPath(state).parent_path(), ec)) {
+    roots.push_back(LaneMapPath(state).parent_path());
+  }
+  return roots;
+}
+
+std::string BacklogWebviewService::SourceKey(const std::filesystem::path& path) {
+  return path.lexically_normal().generic_string();
+}
 
-  for (const auto& root : roots) {
-    if (!std::filesystem::exists(root)) {
-      continue;
-    }
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
-      if (!entry.is_regular_file()) {
+bool BacklogWebviewService::StatSource(SourceFile& source) {
+  FileStat stat;
+  if (!StatFile(source.path, stat)) {
+    return false;
+  }
+  source.mtime = stat.mtime;
+  source.size = stat.size;
+  if (source.kind == SourceKind::Topic &&
+      StatFile(source.path.parent_path() / "brief.md", stat)) {
+    source.mtime = std::max(source.mtime, stat.mtime);
+    source.size += stat.size + 1;
+  }
+  return true;
+}
+
+std::vector<BacklogWebviewService::SourceFile> BacklogWebviewService::EnumerateSources(
+    const ProductState& state) {
+  // One walk per root: entry types come from the directory listing, so the
+  // only per-file syscall is StatSource's single stat, and trash folders
+  // are pruned instead of walked. A missing root fails the first open.
+  std::vector<SourceFile> sources;
+  constexpr auto kWalkOptions = std::filesystem::directory_options::skip_permission_denied;
+  const auto addTree = [&](const std::filesystem::path& root, const SourceKind kind) {
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(root, kWalkOptions, ec), end;
+         !ec && it != end; it.increment(ec)) {
+      const auto& path = it->path();
+      std::error_code typeError;
+      if (it->is_directory(typeError)) {
+        if (path.filename() == "_trash") {
+          it.disable_recursion_pending();
+        }
         continue;
       }
-      const auto path = entry.path();
-      const auto name = path.filename().string();
-      const bool tracked = IsMarkdownItemFile(path) || name == "manifest.json";
-      if (!tracked) {
+      if (!IsMarkdownItemFile(path) || ShouldSkipPath(path)) {
         continue;
       }
-      if (ShouldSkipPath(path)) {
+      SourceFile source{path, kind, {}, 0};
+      if (StatSource(source)) {
+        sources.push_back(std::move(source));
+      }
+    }
+  };
+  const auto addManifests = [&](const std::filesystem::path& root, const SourceKind kind) {
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(root, kWalkOptions, ec), end;
+         !ec && it != end; it.increment(ec)) {
+      std::error_code typeError;
+      if (!it->is_directory(typeError)) {
         continue;
       }
-      const auto mtime = entry.last_write_time();
-      if (mtime > latest) {
-        latest = mtime;
+      SourceFile source{it->path() / "manifest.json", kind, {}, 0};
+      if (StatSource(source)) {
+        sources.push_back(std::move(source));
       }
     }
+  };
+
+  if (state.scope == SourceScope::Workspace) {
+    addManifests(state.backlogRoot / "topics", SourceKind::Topic);
+    addManifests(state.backlogRoot / "worksets", SourceKind::Workset);
+  } else {
+    addTree(state.productRoot / "items", SourceKind::Item);
+    addTree(state.productRoot / "decisions", SourceKind::Decision);
   }
-  return latest;
+  return sources;
 }
 
-bool BacklogWebviewService::ShouldLoad(const std::string& product,
-                                       bool forceRefresh) {
-  if (forceRefresh) {
-    return true;
+std::optional<BacklogWebviewService::SourceFile>
+BacklogWebviewService::ResolveChangedSource(const std::filesystem::path& changedPath,
+                                            const ProductState& state, bool& removed) {
+  removed = false;
+  const auto path = changedPath.lexically_normal();
+  const auto relativeTo =
+      [&](const std::filesystem::path& root) -> std::optional<std::filesystem::path> {
+    auto relative = path.lexically_relative(root.lexically_normal());
+    if (relative.empty() || *relative.begin() == "..") {
+      return std::nullopt;
+    }
+    return relative;
+  };
+
+  // Manifest sources are keyed by <root>/<name>/manifest.json whichever file
+  // inside the folder changed.
+  const auto manifestSource =
+      [&](const std::filesystem::path& root,
+          const SourceKind kind) -> std::optional<SourceFile> {
+    const auto relative = relativeTo(root);
+    if (!relative || std::distance(relative->begin(), relative->end()) < 2) {
+      return std::nullopt;
+    }
+    return SourceFile{root.lexically_normal() / *relative->begin() / "manifest.json", kind,
+                      {}, 0};
+  };
+
+  std::optional<SourceFile> source;
+  if (state.scope == SourceScope::Workspace) {
+    source = manifestSource(state.backlogRoot / "topics", SourceKind::Topic);
+    if (!source) {
+      source = manifestSource(state.backlogRoot / "worksets", SourceKind::Workset);
+    }
+  } else if (relativeTo(state.productRoot / "items")) {
+    source = SourceFile{path, SourceKind::Item, {}, 0};
+  } else if (relativeTo(state.productRoot / "decisions")) {
+    source = SourceFile{path, SourceKind::Decision, {}, 0};
   }
-  const auto it = cacheByProduct.find(product);
-  if (it == cacheByProduct.end()) {
-    return true;
+  if (!source) {
+    return std::nullopt;
   }
 
-  const auto latest = ScanLatestMtime(ProductRoot(product));
-  return latest > it->second.latestMtime;
+  const bool markdownSource =
+      source->kind == SourceKind::Item || source->kind == SourceKind::Decision;
+  if (markdownSource && (!IsMarkdownItemFile(path) || ShouldSkipPath(path))) {
+    return std::nullopt;
+  }
+  removed = !StatSource(*source);
+  return source;
 }
 
 bool BacklogWebviewService::IsMarkdownItemFile(const std::filesystem::path& path) {
   return path.extension() == ".md";
 }
 
+bool BacklogWebviewService::IsTrackedFile(const std::filesystem::path& path) {
+  const bool tracked = IsMarkdownItemFile(path) || path.filename() == "manifest.json" ||
+                       path.filename() == "kanban.json";
+  return tracked && !ShouldSkipPath(path);
+}
+
 bool BacklogWebviewService::ShouldSkipPath(const std::filesystem::path& path) {
-  const auto filename = path.filename().string();
-  if (filename == "README.md") {
-    return true;
-  }
-  if (filename.size() >= 9 &&
-      filename.substr(filename.size() - 9) == ".index.md") {
-    return true;
-  }
+  // Scans the native string in place; iterating the path would build a
+  // path object per component.
+  using Char = std::filesystem::path::value_type;
+  const std::basic_string_view<Char> native = path.native();
+  const auto equals = [](const std::basic_string_view<Char> text, const std::string_view ascii) {
+    return std::equal(text.begin(), text.end(), ascii.begin(), ascii.end(),
+                      [](const Char left, const char right) {
+                        return left == static_cast<Char>(right);
+                      });
+  };
+  const auto isSeparator = [](const Char c) {
+    return c == '/' || c == std::filesystem::path::preferred_separator;
+  };
 
-  for (const auto& part : path) {
-    if (part.string() == "_trash") {
+  size_t begin = 0;
+  while (true) {
+    size_t end = begin;
+    while (end < native.size() && !isSeparator(native[end])) {
+      ++end;
+    }
+    const auto part = native.substr(begin, end - begin);
+    if (equals(part, "_trash")) {
       return true;
     }
+    if (end == native.size()) {
+      constexpr std::string_view kIndexSuffix = ".index.md";
+      return equals(part, "README.md") ||
+             (part.size() >= kIndexSuffix.size() &&
+              equals(part.substr(part.size() - kIndexSuffix.size()), kIndexSuffix));
+    }
+    begin = end + 1;
   }
-
-  return false;
 }
 
 std::string BacklogWebviewService::NormalizeTypeFromPath(
@@ -213,108 +910,43 @@ std::string BacklogWebviewService::NormalizeTypeFromPath(
   return "Unknown";
 }
 
-std::unordered_map<std::string, std::string>
-BacklogWebviewService::ParseFrontmatterMap(const std::string& content, bool& ok,
-                                           std::string& error) {
-  std::unordered_map<std::string, std::string> result;
-  ok = false;
-  error.clear();
-
-  const auto lines = SplitLines(content);
-  if (lines.empty() || Trim(lines.front()) != "---") {
-    error = "Missing frontmatter start marker";
-    return result;
-  }
-
-  bool foundEnd = false;
-  std::string currentKey;
-  for (size_t i = 1; i < lines.size(); ++i) {
-    const auto raw = lines[i];
-    const auto trimmed = Trim(raw);
-    if (trimmed == "---") {
-      foundEnd = true;
-      break;
-    }
-    if (trimmed.empty()) {
-      continue;
-    }
-
-    const auto keyPos = raw.find(':');
-    const bool likelyKeyLine = keyPos != std::string::npos &&
-                               !raw.empty() && raw[0] != ' ' && raw[0] != '\t';
-    if (likelyKeyLine) {
-      currentKey = Trim(raw.substr(0, keyPos));
-      auto value = Trim(raw.substr(keyPos + 1));
-      result[currentKey] = NormalizeNullToken(Unquote(value));
-      continue;
-    }
-
-    if (!currentKey.empty() && (StartsWith(raw, "  -") || StartsWith(raw, "- "))) {
-      auto itemValue = Trim(raw);
-      if (StartsWith(itemValue, "- ")) {
-        itemValue = Trim(itemValue.substr(2));
-      } else if (StartsWith(itemValue, "-")) {
-        itemValue = Trim(itemValue.substr(1));
-      } else if (StartsWith(itemValue, "  -")) {
-        itemValue = Trim(itemValue.substr(3));
-      }
-      if (!itemValue.empty()) {
-        if (!result[currentKey].empty()) {
-          result[currentKey] += ",";
-        }
-        result[currentKey] += NormalizeNullToken(Unquote(itemValue));
-      }
-    }
-  }
-
-  if (!foundEnd) {
-    error = "Missing frontmatter end marker";
-    return result;
-  }
-
-  ok = true;
-  return result;
-}
-
 ItemRecord BacklogWebviewService::ParseItem(const std::filesystem::path& itemPath,
-                                            const std::filesystem::path& productRoot) {
+                                            const std::filesystem::path& productRoot,
+                                            std::string& content) {
   ItemRecord item;
   item.valid = false;
-  item.sourceKind = "Item";
+  item.sourceKind = Symbol("Item");
   item.relativePath =
       std::filesystem::relative(itemPath, productRoot).generic_string();
 
-  bool fileOk = false;
   std::string readError;
-  const auto content = ReadTextFile(itemPath, fileOk, readError);
-  if (!fileOk) {
+  if (!ReadTextFile(itemPath, content, readError)) {
     item.parseError = readError;
     return item;
   }
-  item.rawContent = content;
+  item.contentPath = itemPath;
 
-  bool ok = false;
+  std::string declaredType;
+  std::string state;
+  const frontmatter::Field fields[] = {
+      {"id", &item.id},           {"type", &declaredType},     {"title", &item.title},
+      {"state", &state},          {"parent", &item.parent},    {"created", &item.created},
+      {"updated", &item.updated},
+  };
   std::string error;
-  auto map = ParseFrontmatterMap(content, ok, error);
-  if (!ok) {
+  if (!frontmatter::Parse(content, fields, error)) {
     item.parseError = error;
     return item;
   }
-
-  item.id = map["id"];
-  item.type = NormalizeTypeFromPath(itemPath, map["type"]);
-  item.title = map["title"];
-  item.state = map["state"];
-  item.parent = map["parent"];
-  item.created = map["created"];
-  item.updated = map["updated"];
+  item.type = Symbol(NormalizeTypeFromPath(itemPath, declaredType));
+  item.state = Symbol(state);
 
   if (item.id.empty()) {
     item.parseError = "Missing id";
     return item;
   }
 
-  if (text::ToLower(item.id) == "null") {
+  if (text::EqualsIgnoreCase(item.id, "null")) {
     item.parseError = "Invalid id";
     return item;
   }
@@ -324,7 +956,7 @@ ItemRecord BacklogWebviewService::ParseItem(const std::filesystem::path& itemPat
   }
 
   if (item.state.empty()) {
-    item.state = "Proposed";
+    item.state = Symbol("Proposed");
   }
 
   item.valid = true;
@@ -333,67 +965,66 @@ ItemRecord BacklogWebviewService::ParseItem(const std::filesystem::path& itemPat
 
 ItemRecord BacklogWebviewService::ParseDecision(
     const std::filesystem::path& decisionPath,
-    const std::filesystem::path& productRoot) {
+    const std::filesystem::path& productRoot, std::string& content) {
   ItemRecord item;
   item.valid = false;
-  item.sourceKind = "Decision";
-  item.type = "ADR";
+  item.sourceKind = Symbol("Decision");
+  item.type = Symbol("ADR");
   item.relativePath =
       std::filesystem::relative(decisionPath, productRoot).generic_string();
 
-  bool fileOk = false;
   std::string readError;
-  const auto content = ReadTextFile(decisionPath, fileOk, readError);
-  if (!fileOk) {
+  if (!ReadTextFile(decisionPath, content, readError)) {
     item.parseError = readError;
     return item;
   }
-  item.rawContent = content;
+  item.contentPath = decisionPath;
 
-  bool ok = false;
+  std::string state;
+  const frontmatter::Field fields[] = {
+      {"id", &item.id},
+      {"title", &item.title},
+      {"status", &state},
+      {"date", &item.created},
+  };
   std::string error;
-  auto map = ParseFrontmatterMap(content, ok, error);
-  if (!ok) {
+  if (!frontmatter::Parse(content, fields, error)) {
     item.parseError = error;
     return item;
   }
+  item.state = Symbol(state);
 
-  item.id = map["id"];
   if (item.id.empty()) {
     item.id = decisionPath.stem().string();
   }
-  item.title = map["title"];
   if (item.title.empty()) {
     item.title = decisionPath.stem().string();
   }
-  item.state = map["status"];
   if (item.state.empty()) {
-    item.state = "Proposed";
+    item.state = Symbol("Proposed");
   }
-  item.created = map["date"];
-  item.updated = map["date"];
+  item.updated = item.created;
   item.valid = true;
   return item;
 }
 
 Json::Value BacklogWebviewService::ParseJsonFile(const std::filesystem::path& jsonPath,
-                                                 bool& ok,
+                                                 std::string& text, bool& ok,
                                                  std::string& error) {
   ok = false;
-  error.clear();
-  bool readOk = false;
   std::string readError;
-  const auto text = ReadTextFile(jsonPath, readOk, readError);
-  if (!readOk) {
+  if (!ReadTextFile(jsonPath, text, readError)) {
     error = readError;
     return Json::Value(Json::nullValue);
   }
+  error.clear();
 
-  Json::CharReaderBuilder builder;
+  // Parsed in place rather than through an istringstream copy.
+  const Json::CharReaderBuilder builder;
+  const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
   std::string parseErrors;
-  std::istringstream input(text);
   Json::Value root;
-  if (!Json::parseFromStream(builder, input, &root, &parseErrors)) {
+  if (!reader->parse(text.data(), text.data() + text.size(), &root, &parseErrors)) {
     error = parseErrors;
     return Json::Value(Json::nullValue);
   }
@@ -403,19 +1034,20 @@ Json::Value BacklogWebviewService::ParseJsonFile(const std::filesystem::path& js
 
 ItemRecord BacklogWebviewService::ParseTopicManifest(
     const std::filesystem::path& topicManifestPath,
-    const std::filesystem::path& backlogRoot) {
+    const std::filesystem::path& backlogRoot, std::string& content) {
   ItemRecord item;
   item.valid = false;
-  item.sourceKind = "Topic";
-  item.type = "Topic";
+  item.sourceKind = Symbol("Topic");
+  item.type = Symbol("Topic");
   item.relativePath =
       std::filesystem::relative(topicManifestPath, backlogRoot).generic_string();
 
   bool ok = false;
   std::string error;
-  const auto manifest = ParseJsonFile(topicManifestPath, ok, error);
+  const auto manifest = ParseJsonFile(topicManifestPath, content, ok, error);
   if (!ok) {
     item.parseError = error;
+    content.clear();
     return item;
   }
 
@@ -423,18 +1055,21 @@ ItemRecord BacklogWebviewService::ParseTopicManifest(
                         .asString();
   item.id = "TOPIC-" + slug;
   item.title = slug;
-  item.state = manifest.get("status", "open").asString();
+  item.state = Symbol(manifest.get("status", "open").asString());
   item.created = manifest.get("created_at", "").asString();
   item.updated = manifest.get("updated_at", "").asString();
 
-  bool readOk = false;
+  // The body is brief.md when readable, otherwise the manifest text already
+  // in content.
   std::string readError;
   const auto briefPath = topicManifestPath.parent_path() / "brief.md";
+  item.contentPath = topicManifestPath;
   if (std::filesystem::exists(briefPath)) {
-    item.rawContent = ReadTextFile(briefPath, readOk, readError);
-  }
-  if (!readOk) {
-    item.rawContent = ReadTextFile(topicManifestPath, readOk, readError);
+    if (ReadTextFile(briefPath, content, readError)) {
+      item.contentPath = briefPath;
+    } else {
+      ReadTextFile(topicManifestPath, content, readError);
+    }
   }
   item.valid = true;
   return item;
@@ -442,19 +1077,20 @@ ItemRecord BacklogWebviewService::ParseTopicManifest(
 
 ItemRecord BacklogWebviewService::ParseWorksetManifest(
     const std::filesystem::path& worksetManifestPath,
-    const std::filesystem::path& backlogRoot) {
+    const std::filesystem::path& backlogRoot, std::string& content) {
   ItemRecord item;
   item.valid = false;
-  item.sourceKind = "Workset";
-  item.type = "Workset";
+  item.sourceKind = Symbol("Workset");
+  item.type = Symbol("Workset");
   item.relativePath =
       std::filesystem::relative(worksetManifestPath, backlogRoot).generic_string();
 
   bool ok = false;
   std::string error;
-  const auto manifest = ParseJsonFile(worksetManifestPath, ok, error);
+  const auto manifest = ParseJsonFile(worksetManifestPath, content, ok, error);
   if (!ok) {
     item.parseError = error;
+    content.clear();
     return item;
   }
 
@@ -462,13 +1098,12 @@ ItemRecord BacklogWebviewService::ParseWorksetManifest(
                         .asString();
   item.id = "WORKSET-" + name;
   item.title = name;
-  item.state = manifest.get("status", "open").asString();
+  item.state = Symbol(manifest.get("status", "open").asString());
   item.created = manifest.get("created_at", "").asString();
   item.updated = manifest.get("updated_at", "").asString();
 
-  bool readOk = false;
-  std::string readError;
-  item.rawContent = ReadTextFile(worksetManifestPath, readOk, readError);
+  // The manifest text read above doubles as the body.
+  item.contentPath = worksetManifestPath;
   item.valid = true;
   return item;
 }
@@ -477,10 +1112,10 @@ Json::Value BacklogWebviewService::ItemToJson(const ItemRecord& item,
                                               const bool includeContent) {
   Json::Value value(Json::objectValue);
   value["id"] = item.id;
-  value["type"] = item.type;
-  value["source_kind"] = item.sourceKind;
+  value["type"] = item.type.str();
+  value["source_kind"] = item.sourceKind.str();
   value["title"] = item.title;
-  value["state"] = item.state;
+  value["state"] = item.state.str();
   value["parent"] = item.parent;
   value["created"] = item.created;
   value["updated"] = item.updated;
@@ -515,133 +1150,730 @@ std::string BacklogWebviewService::ToIsoString(
   return buffer;
 }
 
-void BacklogWebviewService::LoadProduct(const std::string& product,
-                                        bool forceRefresh) {
-  if (!ShouldLoad(product, forceRefresh)) {
-    return;
+ItemRecord BacklogWebviewService::ParseSource(const SourceFile& source,
+                                              const ProductState& state) const {
+  // In lazy mode bodies are re-read from contentPath by GetItem and only the
+  // parsed fields stay resident, so each parser thread reads into one reused
+  // buffer instead of allocating per file.
+  thread_local std::string lazyBuffer;
+  std::string ownedContent;
+  auto& content = options.lazyContent ? lazyBuffer : ownedContent;
+
+  ItemRecord item;
+  switch (source.kind) {
+    case SourceKind::Item:
+      item = ParseItem(source.path, state.productRoot, content);
+      break;
+    case SourceKind::Decision:
+      item = ParseDecision(source.path, state.productRoot, content);
+      break;
+    case SourceKind::Topic:
+      item = ParseTopicManifest(source.path, state.backlogRoot, content);
+      break;
+    case SourceKind::Workset:
+      item = ParseWorksetManifest(source.path, state.backlogRoot, content);
+      break;
+  }
+  FinishRecord(item);
+  if (!options.lazyContent) {
+    item.rawContent = std::move(content);
+  } else {
+    item.bodyOnDisk = !item.contentPath.empty();
+    if (lazyBuffer.capacity() > kMaxReusedBufferBytes) {
+      std::string().swap(lazyBuffer);
+    }
   }
+  return item;
+}
 
-  ProductCache productCache;
-  const auto productRoot = ProductRoot(product);
-  const auto itemsRoot = productRoot / "items";
-  productCache.latestMtime = ScanLatestMtime(productRoot);
+std::string BacklogWebviewService::ItemContent(const ItemRecord& item) const {
+  // Eagerly parsed records carry their body; lazy and index-restored ones
+  // re-read it.
+  if (!item.bodyOnDisk) {
+    return item.rawContent;
+  }
+  const auto text = contentCache->Read(item.contentPath);
+  return text ? *text : std::string();
+}
 
-  if (!std::filesystem::exists(itemsRoot)) {
-    productCache.warnings.push_back("Missing items directory");
-    cacheByProduct[product] = std::move(productCache);
+void BacklogWebviewService::SelectPrimary(ProductCache& productCache,
+                                          const std::string_view id) {
+  const auto it = productCache.idIndexes.find(id);
+  if (it == productCache.idIndexes.end() || it->second.empty()) {
+    if (it != productCache.idIndexes.end()) {
+      productCache.idIndexes.erase(it);
+    }
+    if (const auto primaryIt = productCache.primaryById.find(id);
+        primaryIt != productCache.primaryById.end()) {
+      productCache.primaryById.erase(primaryIt);
+    }
     return;
   }
 
-  for (const auto& entry : std::filesystem::recursive_directory_iterator(itemsRoot)) {
-    if (!entry.is_regular_file()) {
-      continue;
+  const auto& indexes = it->second;
+  auto primary = indexes.front();
+  for (const auto index : indexes) {
+    const auto& candidate = *productCache.allItems[index];
+    const auto& current = *productCache.allItems[primary];
+    // Integer keys when both stamps parse; the text ordering otherwise.
+    const auto order = candidate.updatedAt != kNoTimestamp && current.updatedAt != kNoTimestamp
+                           ? candidate.updatedAt <=> current.updatedAt
+                           : candidate.updated <=> current.updated;
+    if (order > 0 || (order == 0 && candidate.relativePath < current.relativePath)) {
+      primary = index;
+    }
+  }
+  IdEntry(productCache.primaryById, id) = primary;
+}
+
+void BacklogWebviewService::MergeRecords(ProductState& state, ProductCache& productCache,
+                                         const std::vector<std::string>& removals,
+                                         std::vector<PendingRecord>& pending,
+                                         std::pmr::memory_resource* scratch) {
+  static const char* const kWarningLabels[] = {"Invalid item", "Invalid decision",
+                                               "Invalid topic", "Invalid workset"};
+  // Warnings stay ordered by source kind, then path, like a full scan.
+  const auto warningKey = [](const SourceKind kind, const std::string& key) {
+    return static_cast<char>('0' + static_cast<int>(kind)) + key;
+  };
+
+  std::pmr::set<std::pmr::string> touchedIds(scratch);
+  const auto releaseSlot = [&](const size_t slot) {
+    auto& item = productCache.allItems[slot];
+    if (item && !item->id.empty()) {
+      auto& indexes = IdEntry(productCache.idIndexes, item->id);
+      indexes.erase(std::remove(indexes.begin(), indexes.end(), slot), indexes.end());
+      touchedIds.emplace(item->id);
     }
-    if (!IsMarkdownItemFile(entry.path()) || ShouldSkipPath(entry.path())) {
+    item.reset();
+  };
+
+  for (const auto& key : removals) {
+    const auto fileIt = state.files.find(key);
+    if (fileIt == state.files.end()) {
       continue;
     }
+    releaseSlot(fileIt->second.slot);
+    state.freeSlots.push_back(fileIt->second.slot);
+    state.warningsBySource.erase(warningKey(fileIt->second.kind, key));
+    state.files.erase(fileIt);
+  }
+
+  for (auto& entry : pending) {
+    const auto fileIt = state.files.find(entry.key);
+
+    size_t slot = 0;
+    if (fileIt != state.files.end()) {
+      slot = fileIt->second.slot;
+      releaseSlot(slot);
+    } else if (!state.freeSlots.empty()) {
+      slot = state.freeSlots.back();
+      state.freeSlots.pop_back();
+    } else {
+      slot = productCache.allItems.size();
+      productCache.allItems.emplace_back();
+    }
 
-    auto item = ParseItem(entry.path(), productRoot);
-    const auto index = productCache.allItems.size();
+    const auto& item = *entry.record;
+    const auto sortedKey = warningKey(entry.kind, entry.key);
     if (!item.valid) {
-      productCache.warnings.push_back("Invalid item: " + item.relativePath +
-                                      " - " + item.parseError);
+      state.warningsBySource[sortedKey] =
+          std::string(kWarningLabels[static_cast<int>(entry.kind)]) + ": " +
+          item.relativePath + " - " + item.parseError;
+    } else {
+      state.warningsBySource.erase(sortedKey);
     }
-    productCache.allItems.push_back(std::move(item));
+    if (!item.id.empty()) {
+      IdEntry(productCache.idIndexes, item.id).push_back(slot);
+      touchedIds.emplace(item.id);
+    }
+    productCache.allItems[slot] = std::move(entry.record);
+    state.files[std::move(entry.key)] = FileRecord{entry.kind, entry.mtime, entry.size, slot};
+    productCache.latestMtime = std::max(productCache.latestMtime, entry.mtime);
   }
 
-  const auto decisionsRoot = productRoot / "decisions";
-  if (std::filesystem::exists(decisionsRoot)) {
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(decisionsRoot)) {
-      if (!entry.is_regular_file()) {
-        continue;
-      }
-      if (!IsMarkdownItemFile(entry.path()) || ShouldSkipPath(entry.path())) {
-        continue;
-      }
-      auto item = ParseDecision(entry.path(), productRoot);
-      if (!item.valid) {
-        productCache.warnings.push_back("Invalid decision: " + item.relativePath +
-                                        " - " + item.parseError);
-      }
-      productCache.allItems.push_back(std::move(item));
-    }
+  for (const auto& id : touchedIds) {
+    SelectPrimary(productCache, id);
   }
 
-  const auto backlogRoot = productsRoot.parent_path();
-  const auto topicsRoot = backlogRoot / "topics";
-  if (std::filesystem::exists(topicsRoot)) {
-    for (const auto& entry : std::filesystem::directory_iterator(topicsRoot)) {
-      if (!entry.is_directory()) {
-        continue;
-      }
-      const auto manifestPath = entry.path() / "manifest.json";
-      if (!std::filesystem::exists(manifestPath)) {
-        continue;
-      }
-      auto item = ParseTopicManifest(manifestPath, backlogRoot);
-      if (!item.valid) {
-        productCache.warnings.push_back("Invalid topic: " + item.relativePath +
-                                        " - " + item.parseError);
-      }
-      productCache.allItems.push_back(std::move(item));
-    }
+  productCache.warnings.clear();
+  for (const auto& [key, warning] : state.warningsBySource) {
+    productCache.warnings.push_back(warning);
   }
+}
 
-  const auto worksetsRoot = backlogRoot / "worksets";
-  if (std::filesystem::exists(worksetsRoot)) {
-    for (const auto& entry : std::filesystem::directory_iterator(worksetsRoot)) {
-      if (!entry.is_directory()) {
-        continue;
-      }
-      const auto manifestPath = entry.path() / "manifest.json";
-      if (!std::filesystem::exists(manifestPath)) {
-        continue;
-      }
-      auto item = ParseWorksetManifest(manifestPath, backlogRoot);
-      if (!item.valid) {
-        productCache.warnings.push_back("Invalid workset: " + item.relativePath +
-                                        " - " + item.parseError);
-      }
-      productCache.allItems.push_back(std::move(item));
+bool BacklogWebviewService::ApplySourceChanges(
+    ProductState& state, ProductCache& productCache, const std::vector<SourceFile>& upserts,
+    const std::vector<std::string>& removals, std::pmr::memory_resource* scratch) const {
+  std::vector<PendingRecord> pending;
+  std::pmr::vector<const SourceFile*> pendingSources(scratch);
+  for (const auto& source : upserts) {
+    auto key = SourceKey(source.path);
+    const auto fileIt = state.files.find(key);
+    if (fileIt != state.files.end() && fileIt->second.mtime == source.mtime &&
+        fileIt->second.size == source.size) {
+      continue;
     }
-  }
+    pending.push_back(PendingRecord{std::move(key), source.kind, source.mtime, source.size, {}});
+    pendingSources.push_back(&source);
+  }
+
+  // Parsing fans out across the pool; merging stays sequential in upsert
+  // order so slots, warnings and primary selection are stable.
+  loadPool->ParallelFor(pending.size(), [&](const size_t index) {
+    pending[index].record =
+        std::make_shared<const ItemRecord>(ParseSource(*pendingSources[index], state));
+  });
+  MergeRecords(state, productCache, removals, pending, scratch);
+  state.metrics->filesParsed.fetch_add(pending.size(), std::memory_order_relaxed);
+  return !pending.empty() || !removals.empty();
+}
 
-  for (size_t i = 0; i < productCache.allItems.size(); ++i) {
-    const auto& item = productCache.allItems[i];
-    if (!item.id.empty()) {
-      productCache.idIndexes[item.id].push_back(i);
+void BacklogWebviewService::MergeSharedSources(ProductState& state,
+                                               ProductCache& productCache,
+                                               ProductState& shared,
+                                               std::pmr::memory_resource* scratch) {
+  // The shared loader updates its file table and publishes its snapshot
+  // under its load mutex, so holding it here keeps both consistent. Lock
+  // order is always product, then shared.
+  std::lock_guard sharedLock(shared.loadMutex);
+  const auto sharedCache = shared.Snapshot();
+  productCache.sharedGeneration = sharedCache->generation;
+
+  std::vector<std::string> removals;
+  for (const auto& [key, record] : state.files) {
+    if ((record.kind == SourceKind::Topic || record.kind == SourceKind::Workset) &&
+        !shared.files.count(key)) {
+      removals.push_back(key);
     }
   }
+  std::sort(removals.begin(), removals.end());
 
-  for (const auto& [id, indexes] : productCache.idIndexes) {
-    if (indexes.empty()) {
+  std::vector<PendingRecord> pending;
+  for (const auto& [key, record] : shared.files) {
+    productCache.latestMtime = std::max(productCache.latestMtime, record.mtime);
+    const auto fileIt = state.files.find(key);
+    if (fileIt != state.files.end() && fileIt->second.mtime == record.mtime &&
+        fileIt->second.size == record.size) {
       continue;
     }
-    auto primary = indexes.front();
-    for (const auto index : indexes) {
-      const auto& candidate = productCache.allItems[index];
-      const auto& current = productCache.allItems[primary];
-      if (candidate.updated > current.updated) {
-        primary = index;
+    pending.push_back(PendingRecord{key, record.kind, record.mtime, record.size,
+                                    sharedCache->allItems[record.slot]});
+  }
+  std::sort(pending.begin(), pending.end(),
+            [](const PendingRecord& left, const PendingRecord& right) {
+              return std::tie(left.kind, left.key) < std::tie(right.kind, right.key);
+            });
+  MergeRecords(state, productCache, removals, pending, scratch);
+}
+
+std::shared_ptr<BacklogWebviewService::ProductState> BacklogWebviewService::SharedState() {
+  {
+    std::shared_lock lock(stateMutex);
+    if (sharedState) {
+      return sharedState;
+    }
+  }
+
+  std::unique_lock lock(stateMutex);
+  if (!sharedState) {
+    sharedState = NewSharedState(productsRoot);
+  }
+  return sharedState;
+}
+
+std::shared_ptr<const BacklogWebviewService::ProductCache>
+BacklogWebviewService::AcquireShared(ProductState& shared) {
+  auto snapshot = shared.Snapshot();
+  if (snapshot && !watcher->HasChanges(shared.watchKey)) {
+    shared.metrics->snapshotHits.fetch_add(1, std::memory_order_relaxed);
+    return snapshot;
+  }
+  std::lock_guard loadLock(shared.loadMutex);
+  if (shared.retired.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  snapshot = shared.Snapshot();
+  if (snapshot && !watcher->HasChanges(shared.watchKey)) {
+    shared.metrics->snapshotHits.fetch_add(1, std::memory_order_relaxed);
+    return snapshot;
+  }
+  shared.metrics->snapshotMisses.fetch_add(1, std::memory_order_relaxed);
+  return LoadProduct(shared, snapshot, false, nullptr);
+}
+
+std::shared_ptr<const BacklogWebviewService::ProductCache>
+BacklogWebviewService::AcquireProduct(const std::string& product, bool forceRefresh,
+                                      const bool markUsed) {
+  // Only a Refresh between the lookup and the load makes this go around
+  // again; the states it retired have been replaced by then.
+  for (;;) {
+    const auto shared = SharedState();
+    const auto sharedSnapshot = AcquireShared(*shared);
+    if (!sharedSnapshot) {
+      continue;
+    }
+    const auto state = StateFor(product);
+    if (markUsed) {
+      state->lastUsed.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                            std::memory_order_relaxed);
+    }
+    auto snapshot = state->Snapshot();
+    // The watcher records what changed under the tracked roots, so a cache
+    // hit costs a map lookup instead of a directory walk. Topic and workset
+    // changes arrive as a new shared generation.
+    const auto fresh = [&] {
+      return snapshot && !forceRefresh &&
+             snapshot->sharedGeneration == sharedSnapshot->generation &&
+             !watcher->HasChanges(state->watchKey);
+    };
+    if (fresh()) {
+      state->metrics->snapshotHits.fetch_add(1, std::memory_order_relaxed);
+      return snapshot;
+    }
+
+    // Single flight: concurrent misses queue here and reuse the winner's result.
+    std::lock_guard loadLock(state->loadMutex);
+    if (state->retired.load(std::memory_order_acquire)) {
+      continue;
+    }
+    snapshot = state->Snapshot();
+    if (fresh()) {
+      state->metrics->snapshotHits.fetch_add(1, std::memory_order_relaxed);
+      return snapshot;
+    }
+    state->metrics->snapshotMisses.fetch_add(1, std::memory_order_relaxed);
+    return LoadProduct(*state, snapshot, forceRefresh, shared.get());
+  }
+}
+
+std::shared_ptr<const BacklogWebviewService::ProductCache>
+BacklogWebviewService::LoadProduct(ProductState& state,
+                                   const std::shared_ptr<const ProductCache>& previous,
+                                   bool forceRefresh, ProductState* shared) {
+  const auto loadStart = std::chrono::steady_clock::now();
+  const bool rebuild = forceRefresh || !previous;
+
+  // Product loaders merge the shared topics/worksets by pointer; see
+  // MergeSharedSources for the locking.
+  const auto sharedCache = shared ? shared->Snapshot() : nullptr;
+  const bool sharedChanged =
+      sharedCache && (rebuild || previous->sharedGeneration != sharedCache->generation);
+
+  FileWatcher::Delta delta;
+  if (rebuild) {
+    // The full scan covers whatever was pending; Arm below no longer clears it.
+    watcher->ConsumeChanges(state.watchKey);
+    delta.dirty = true;
+    delta.rescan = true;
+  } else {
+    delta = watcher->ConsumeChanges(state.watchKey);
+    if (!delta.dirty && !sharedChanged) {
+      return previous;
+    }
+  }
+  if (delta.dirty) {
+    watcher->Arm(state.watchKey, TrackedRoots(state));
+  }
+
+  if (rebuild) {
+    state.files.clear();
+    state.freeSlots.clear();
+    state.warningsBySource.clear();
+  }
+  // Records are shared between snapshots, so copying the previous one only
+  // copies pointers and index tables.
+  auto next = rebuild ? std::make_shared<ProductCache>()
+                      : std::make_shared<ProductCache>(*previous);
+  next->sharedGeneration = sharedCache ? sharedCache->generation : 0;
+
+  if (state.scope == SourceScope::Product &&
+      !std::filesystem::exists(state.productRoot / "items")) {
+    state.files.clear();
+    state.freeSlots.clear();
+    state.warningsBySource.clear();
+    next = std::make_shared<ProductCache>();
+    next->sharedGeneration = sharedCache ? sharedCache->generation : 0;
+    next->latestMtime = std::filesystem::file_time_type::min();
+    next->warnings.push_back("Missing items directory");
+    next->generation = ++generationCounter;
+    next->bytes = EstimateBytes(*next);
+    state.Publish(next);
+    state.metrics->items.store(0, std::memory_order_relaxed);
+    state.metrics->snapshotBytes.store(next->bytes, std::memory_order_relaxed);
+    state.metrics->load.Observe(std::chrono::steady_clock::now() - loadStart);
+    return next;
+  }
+
+  // A cold start resumes from the on-disk index; the rescan below then only
+  // reparses files whose stat changed since it was written.
+  const bool restored = !previous && !forceRefresh && options.persistentIndex &&
+                        indexRemovals.load(std::memory_order_acquire) == 0 &&
+                        RestoreIndex(state, *next);
+  // Restored records stay bodiless until their file changes, and merged
+  // shared records bring their parent's mode along.
+  next->contentOnDisk = next->contentOnDisk || options.lazyContent || restored ||
+                        (sharedCache && sharedCache->contentOnDisk);
+
+  // Temporaries of this load (seen keys, parse queue, touched ids) come from
+  // one arena that is dropped in a single release when the load returns.
+  std::pmr::monotonic_buffer_resource scratch;
+  std::vector<SourceFile> upserts;
+  std::vector<std::string> removals;
+  bool laneMapChanged = delta.rescan;
+  std::optional<ScopedTimer> scanTimer(std::in_place, state.metrics->scan);
+  if (delta.rescan) {
+    upserts = EnumerateSources(state);
+    std::pmr::unordered_set<std::pmr::string, IdHash, IdEqual> seen(&scratch);
+    seen.reserve(upserts.size());
+    next->latestMtime = std::filesystem::file_time_type::min();
+    for (const auto& source : upserts) {
+      seen.emplace(SourceKey(source.path));
+      next->latestMtime = std::max(next->latestMtime, source.mtime);
+    }
+    for (const auto& [key, record] : state.files) {
+      const bool sharedRecord =
+          record.kind == SourceKind::Topic || record.kind == SourceKind::Workset;
+      if (!seen.count(key) && (state.scope == SourceScope::Workspace || !sharedRecord)) {
+        removals.push_back(key);
+      }
+    }
+  } else {
+    for (const auto& changedPath : delta.paths) {
+      if (state.scope == SourceScope::Product &&
+          changedPath.lexically_normal() == LaneMapPath(state).lexically_normal()) {
+        laneMapChanged = true;
+        continue;
+      }
+      bool removed = false;
+      auto source = ResolveChangedSource(changedPath, state, removed);
+      if (!source) {
+        continue;
+      }
+      if (removed) {
+        removals.push_back(SourceKey(source->path));
+      } else {
+        upserts.push_back(std::move(*source));
+      }
+    }
+  }
+
+  std::sort(upserts.begin(), upserts.end(), [](const SourceFile& left, const SourceFile& right) {
+    return std::tie(left.kind, left.path) < std::tie(right.kind, right.path);
+  });
+  upserts.erase(std::unique(upserts.begin(), upserts.end(),
+                            [](const SourceFile& left, const SourceFile& right) {
+                              return left.path == right.path;
+                            }),
+                upserts.end());
+  std::sort(removals.begin(), removals.end());
+  scanTimer.reset();
+  const bool changed = ApplySourceChanges(state, *next, upserts, removals, &scratch);
+  if (sharedCache && (sharedChanged || delta.rescan)) {
+    MergeSharedSources(state, *next, *shared, &scratch);
+  }
+  if (state.scope == SourceScope::Product) {
+    if (!state.laneMap || laneMapChanged) {
+      state.laneMapWarnings.clear();
+      state.laneMap = LoadLaneMap(LaneMapPath(state), state.laneMapWarnings);
+    }
+    next->hierarchy = BuildHierarchy(*next);
+    next->kanban = BuildKanbanIndex(*next, *state.laneMap, state.laneMapWarnings);
+  }
+  next->generation = ++generationCounter;
+  next->bytes = EstimateBytes(*next);
+  state.Publish(next);
+  state.metrics->items.store(next->primaryById.size(), std::memory_order_relaxed);
+  state.metrics->snapshotBytes.store(next->bytes, std::memory_order_relaxed);
+  state.metrics->load.Observe(std::chrono::steady_clock::now() - loadStart);
+  // Merged shared records are not part of a product index, so only this
+  // loader's own changes (or a cold start without one) trigger a rewrite.
+  if (options.persistentIndex && (changed || (!previous && !restored))) {
+    SaveIndex(state, *next);
+  }
+  return next;
+}
+
+std::filesystem::path BacklogWebviewService::IndexDirectory(
+    const std::filesystem::path& backlogRoot) {
+  return backlogRoot / ".cache" / "webview";
+}
+
+std::filesystem::path BacklogWebviewService::ProductIndexPath(
+    const std::filesystem::path& backlogRoot, const std::string& product) {
+  return IndexDirectory(backlogRoot) / "products" / (product + ".idx");
+}
+
+std::filesystem::path BacklogWebviewService::IndexPath(const ProductState& state) {
+  if (state.scope == SourceScope::Workspace) {
+    return IndexDirectory(state.backlogRoot) / "shared.idx";
+  }
+  return ProductIndexPath(state.backlogRoot, state.productRoot.filename().string());
+}
+
+// Layout: owner root, latest mtime, record slots, file table, warnings,
+// idIndexes, primaryById. Product indexes leave out the merged topic and
+// workset slots; those come back by pointer from the shared loader.
+void BacklogWebviewService::SaveIndex(const ProductState& state,
+                                      const ProductCache& productCache) {
+  const auto isForeign = [&](const SourceKind kind) {
+    return state.scope == SourceScope::Product &&
+           (kind == SourceKind::Topic || kind == SourceKind::Workset);
+  };
+  std::vector<bool> skipSlot(productCache.allItems.size(), false);
+  for (const auto& [key, record] : state.files) {
+    if (isForeign(record.kind)) {
+      skipSlot[record.slot] = true;
+    }
+  }
+
+  IndexWriter writer(kIndexMagic, kIndexVersion);
+  writer.String(SourceKey(state.scope == SourceScope::Workspace ? state.backlogRoot
+                                                                : state.productRoot));
+  writer.I64(TimeToInt(productCache.latestMtime));
+
+  writer.U32(static_cast<std::uint32_t>(productCache.allItems.size()));
+  for (size_t slot = 0; slot < productCache.allItems.size(); ++slot) {
+    const auto& item = productCache.allItems[slot];
+    if (!item || skipSlot[slot]) {
+      writer.U8(0);
+      continue;
+    }
+    writer.U8(1);
+    for (const auto* field : {&item->id, &item->type.str(), &item->sourceKind.str(),
+                              &item->title, &item->state.str(), &item->parent, &item->created,
+                              &item->updated, &item->relativePath, &item->parseError}) {
+      writer.String(*field);
+    }
+    writer.String(item->contentPath.generic_string());
+    writer.U8(item->valid ? 1 : 0);
+  }
+
+  std::uint32_t fileCount = 0;
+  for (const auto& [key, record] : state.files) {
+    fileCount += isForeign(record.kind) ? 0 : 1;
+  }
+  writer.U32(fileCount);
+  for (const auto& [key, record] : state.files) {
+    if (isForeign(record.kind)) {
+      continue;
+    }
+    writer.String(key);
+    writer.U8(static_cast<std::uint8_t>(record.kind));
+    writer.I64(TimeToInt(record.mtime));
+    writer.U64(record.size);
+    writer.U32(static_cast<std::uint32_t>(record.slot));
+  }
+
+  std::vector<std::pair<std::string, std::string>> warnings;
+  for (const auto& [key, warning] : state.warningsBySource) {
+    const auto kind = static_cast<SourceKind>(key.front() - '0');
+    if (!isForeign(kind)) {
+      warnings.emplace_back(key, warning);
+    }
+  }
+  writer.U32(static_cast<std::uint32_t>(warnings.size()));
+  for (const auto& [key, warning] : warnings) {
+    writer.String(key);
+    writer.String(warning);
+  }
+
+  std::vector<std::pair<std::string_view, std::vector<std::uint32_t>>> indexes;
+  for (const auto& [id, slots] : productCache.idIndexes) {
+    std::vector<std::uint32_t> kept;
+    for (const auto slot : slots) {
+      if (!skipSlot[slot]) {
+        kept.push_back(static_cast<std::uint32_t>(slot));
       }
-      if (candidate.updated == current.updated && candidate.relativePath < current.relativePath) {
-        primary = index;
+    }
+    if (!kept.empty()) {
+      indexes.emplace_back(id, std::move(kept));
+    }
+  }
+  writer.U32(static_cast<std::uint32_t>(indexes.size()));
+  for (const auto& [id, slots] : indexes) {
+    writer.String(id);
+    writer.U32(static_cast<std::uint32_t>(slots.size()));
+    for (const auto slot : slots) {
+      writer.U32(slot);
+    }
+  }
+
+  std::uint32_t primaryCount = 0;
+  for (const auto& [id, slot] : productCache.primaryById) {
+    primaryCount += skipSlot[slot] ? 0 : 1;
+  }
+  writer.U32(primaryCount);
+  for (const auto& [id, slot] : productCache.primaryById) {
+    if (!skipSlot[slot]) {
+      writer.String(id);
+      writer.U32(static_cast<std::uint32_t>(slot));
+    }
+  }
+
+  // Best effort: a read-only workspace simply keeps cold-starting.
+  writer.Commit(IndexPath(state));
+}
+
+bool BacklogWebviewService::RestoreIndex(ProductState& state, ProductCache& productCache) {
+  IndexReader reader(IndexPath(state), kIndexMagic, kIndexVersion);
+  ProductCache restored;
+  // Built in the target's arena so the final move-assignments steal them.
+  decltype(productCache.idIndexes) idIndexes(productCache.idIndexes.get_allocator());
+  decltype(productCache.primaryById) primaryById(productCache.primaryById.get_allocator());
+  std::unordered_map<std::string, FileRecord> files;
+  std::map<std::string, std::string> warnings;
+
+  std::string owner;
+  std::int64_t latest = 0;
+  std::uint32_t slotCount = 0;
+  if (!reader.String(owner) ||
+      owner != SourceKey(state.scope == SourceScope::Workspace ? state.backlogRoot
+                                                               : state.productRoot) ||
+      !reader.I64(latest) || !reader.U32(slotCount)) {
+    return false;
+  }
+  restored.latestMtime = IntToTime(latest);
+
+  restored.allItems.resize(slotCount);
+  for (std::uint32_t slot = 0; slot < slotCount; ++slot) {
+    std::uint8_t present = 0;
+    if (!reader.U8(present)) {
+      return false;
+    }
+    if (!present) {
+      continue;
+    }
+    ItemRecord item;
+    std::string type;
+    std::string sourceKind;
+    std::string itemState;
+    std::string contentPath;
+    std::uint8_t valid = 0;
+    for (auto* field : {&item.id, &type, &sourceKind, &item.title, &itemState, &item.parent,
+                        &item.created, &item.updated, &item.relativePath, &item.parseError,
+                        &contentPath}) {
+      reader.String(*field);
+    }
+    if (!reader.U8(valid)) {
+      return false;
+    }
+    item.type = Symbol(type);
+    item.sourceKind = Symbol(sourceKind);
+    item.state = Symbol(itemState);
+    item.contentPath = contentPath;
+    item.bodyOnDisk = !contentPath.empty();
+    item.valid = valid != 0;
+    FinishRecord(item);
+    restored.allItems[slot] = std::make_shared<const ItemRecord>(std::move(item));
+  }
+
+  const auto liveSlot = [&](const std::uint32_t slot) {
+    return slot < slotCount && restored.allItems[slot] != nullptr;
+  };
+
+  std::uint32_t count = 0;
+  if (!reader.U32(count)) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::string key;
+    std::uint8_t kind = 0;
+    std::int64_t mtime = 0;
+    std::uint64_t size = 0;
+    std::uint32_t slot = 0;
+    if (!reader.String(key) || !reader.U8(kind) || !reader.I64(mtime) || !reader.U64(size) ||
+        !reader.U32(slot) || kind > static_cast<std::uint8_t>(SourceKind::Workset) ||
+        !liveSlot(slot)) {
+      return false;
+    }
+    files[std::move(key)] =
+        FileRecord{static_cast<SourceKind>(kind), IntToTime(mtime), size, slot};
+  }
+
+  if (!reader.U32(count)) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::string key;
+    std::string warning;
+    if (!reader.String(key) || !reader.String(warning) || key.empty()) {
+      return false;
+    }
+    warnings[std::move(key)] = std::move(warning);
+  }
+
+  if (!reader.U32(count)) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::string id;
+    std::uint32_t slots = 0;
+    if (!reader.String(id) || !reader.U32(slots)) {
+      return false;
+    }
+    auto& indexes = IdEntry(idIndexes, id);
+    for (std::uint32_t j = 0; j < slots; ++j) {
+      std::uint32_t slot = 0;
+      if (!reader.U32(slot) || !liveSlot(slot)) {
+        return false;
       }
+      indexes.push_back(slot);
+    }
+  }
+
+  if (!reader.U32(count)) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::string id;
+    std::uint32_t slot = 0;
+    if (!reader.String(id) || !reader.U32(slot) || !liveSlot(slot)) {
+      return false;
+    }
+    IdEntry(primaryById, id) = slot;
+  }
+  if (!reader.AtEnd()) {
+    return false;
+  }
+
+  std::vector<size_t> freeSlots;
+  for (size_t slot = restored.allItems.size(); slot-- > 0;) {
+    if (!restored.allItems[slot]) {
+      freeSlots.push_back(slot);
     }
-    productCache.primaryById[id] = primary;
+  }
+  for (const auto& [key, warning] : warnings) {
+    restored.warnings.push_back(warning);
   }
 
-  cacheByProduct[product] = std::move(productCache);
+  productCache.allItems = std::move(restored.allItems);
+  productCache.idIndexes = std::move(idIndexes);
+  productCache.primaryById = std::move(primaryById);
+  productCache.latestMtime = restored.latestMtime;
+  productCache.warnings = std::move(restored.warnings);
+  state.files = std::move(files);
+  state.freeSlots = std::move(freeSlots);
+  state.warningsBySource = std::move(warnings);
+  return true;
 }
 
 Json::Value BacklogWebviewService::ListProducts() {
   Json::Value data(Json::arrayValue);
-  if (!std::filesystem::exists(productsRoot)) {
-    return data;
+  for (const auto& product : ProductNames(GetProductsRoot())) {
+    data.append(product);
   }
+  return data;
+}
 
+std::vector<std::string> BacklogWebviewService::ProductNames(const std::filesystem::path& root) {
   std::vector<std::string> products;
-  for (const auto& entry : std::filesystem::directory_iterator(productsRoot)) {
+  std::error_code ec;
+  if (!std::filesystem::exists(root, ec)) {
+    return products;
+  }
+
+  for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
     if (!entry.is_directory()) {
       continue;
     }
@@ -651,47 +1883,1122 @@ Json::Value BacklogWebviewService::ListProducts() {
     }
   }
   std::sort(products.begin(), products.end());
-  for (const auto& product : products) {
-    data.append(product);
-  }
-  return data;
+  return products;
 }
 
-Json::Value BacklogWebviewService::ListItems(const std::string& product,
-                                             bool forceRefresh) {
+Json::Value BacklogWebviewService::EmptyViewData(const View view) {
   Json::Value response(Json::objectValue);
-  response["items"] = Json::arrayValue;
+  switch (view) {
+    case View::Items:
+      response["items"] = Json::arrayValue;
+      break;
+    case View::Tree:
+      response["roots"] = Json::arrayValue;
+      break;
+    case View::Kanban:
+      response["lanes"] = Json::objectValue;
+      response["lanes"]["Backlog"] = Json::arrayValue;
+      response["lanes"]["Doing"] = Json::arrayValue;
+      response["lanes"]["Blocked"] = Json::arrayValue;
+      response["lanes"]["Review"] = Json::arrayValue;
+      response["lanes"]["Done"] = Json::arrayValue;
+      response["totals"] = Json::objectValue;
+      for (const auto& lane : response["lanes"].getMemberNames()) {
+        response["totals"][lane] = 0;
+      }
+      response["type_totals"] = Json::objectValue;
+      break;
+  }
   response["warnings"] = Json::arrayValue;
+  return response;
+}
+
+std::shared_ptr<const BacklogWebviewService::ProductCache>
+BacklogWebviewService::AcquireForView(const std::string& product, bool forceRefresh,
+                                      Json::Value& response) {
   if (!IsValidProductName(product)) {
     response["error"] = "Invalid product name";
-    return response;
+    return nullptr;
+  }
+  auto snapshot = AcquireProduct(product, forceRefresh);
+  if (!snapshot) {
+    response["error"] = "Product not found";
+  }
+  return snapshot;
+}
+
+Json::Value BacklogWebviewService::ListedItemJson(const ProductCache& productCache,
+                                                  const size_t primaryIndex,
+                                                  const std::uint32_t fields) {
+  const auto& item = *productCache.allItems[primaryIndex];
+  Json::Value value(Json::objectValue);
+  value["id"] = item.id;
+  if (fields & kFieldCreated) {
+    value["created"] = item.created;
+  }
+  if (fields & kFieldDuplicateCount) {
+    const auto duplicateIt = productCache.idIndexes.find(item.id);
+    if (duplicateIt != productCache.idIndexes.end()) {
+      value["duplicate_count"] = static_cast<Json::UInt64>(duplicateIt->second.size());
+    }
+  }
+  if (fields & kFieldParent) {
+    value["parent"] = item.parent;
+  }
+  if ((fields & kFieldParseError) && !item.parseError.empty()) {
+    value["parse_error"] = item.parseError;
+  }
+  if (fields & kFieldPath) {
+    value["path"] = item.relativePath;
+  }
+  if (fields & kFieldSourceKind) {
+    value["source_kind"] = item.sourceKind.str();
+  }
+  if (fields & kFieldState) {
+    value["state"] = item.state.str();
+  }
+  if (fields & kFieldTitle) {
+    value["title"] = item.title;
+  }
+  if (fields & kFieldType) {
+    value["type"] = item.type.str();
+  }
+  if (fields & kFieldUpdated) {
+    value["updated"] = item.updated;
+  }
+  if (fields & kFieldValid) {
+    value["valid"] = item.valid;
+  }
+  return value;
+}
+
+std::uint32_t BacklogWebviewService::FieldMask(const ItemQuery& query) {
+  if (query.fields.empty()) {
+    return kAllItemFields;
+  }
+  static const std::unordered_map<std::string, ItemField> kByName = {
+      {"created", kFieldCreated}, {"duplicate_count", kFieldDuplicateCount},
+      {"parent", kFieldParent},   {"parse_error", kFieldParseError},
+      {"path", kFieldPath},       {"source_kind", kFieldSourceKind},
+      {"state", kFieldState},     {"title", kFieldTitle},
+      {"type", kFieldType},       {"updated", kFieldUpdated},
+      {"valid", kFieldValid},
+  };
+  std::uint32_t mask = 0;
+  for (const auto& name : query.fields) {
+    if (const auto it = kByName.find(name); it != kByName.end()) {
+      mask |= it->second;
+    }
+  }
+  return mask;
+}
+
+std::string BacklogWebviewService::ItemQueryKey(const ItemQuery& query) {
+  // Unit separators keep list boundaries unambiguous.
+  const auto appendList = [](std::string& key, const std::vector<std::string>& values) {
+    for (const auto& value : values) {
+      key += value;
+      key.push_back('\x1f');
+    }
+    key.push_back('\x1e');
+  };
+  std::string key = query.searchBody ? "b" : "-";
+  key += query.countsOnly ? "c" : "-";
+  key += std::to_string(query.offset) + ',' + std::to_string(query.limit) + ',' +
+         std::to_string(FieldMask(query)) + '\x1e';
+  appendList(key, query.types);
+  appendList(key, query.states);
+  key += query.parent ? "p" + *query.parent : std::string("-");
+  key.push_back('\x1e');
+  key += query.cursor;
+  key.push_back('\x1e');
+  key += query.lane;
+  key.push_back('\x1e');
+  key += query.text;
+  return key;
+}
+
+bool BacklogWebviewService::MatchesFilters(const ItemRecord& item, const ItemQuery& query) {
+  if (!query.types.empty() &&
+      std::find(query.types.begin(), query.types.end(), item.type.str()) == query.types.end()) {
+    return false;
+  }
+  if (!query.states.empty() &&
+      std::none_of(query.states.begin(), query.states.end(), [&](const std::string& state) {
+        return text::EqualsIgnoreCase(item.state.str(), state);
+      })) {
+    return false;
+  }
+  return !query.parent || item.parent == *query.parent;
+}
+
+std::shared_ptr<const std::vector<size_t>> BacklogWebviewService::SlotsById(
+    const ProductCache& productCache) {
+  auto& memo = productCache.search;
+  std::lock_guard lock(memo.mutex);
+  if (!memo.byId) {
+    auto slots = std::make_shared<std::vector<size_t>>();
+    slots->reserve(productCache.primaryById.size());
+    for (const auto& [id, primaryIndex] : productCache.primaryById) {
+      slots->push_back(primaryIndex);
+    }
+    std::sort(slots->begin(), slots->end(), [&](const size_t left, const size_t right) {
+      return productCache.allItems[left]->id < productCache.allItems[right]->id;
+    });
+    memo.byId = std::move(slots);
+  }
+  return memo.byId;
+}
+
+BacklogWebviewService::ItemSelection BacklogWebviewService::SelectItems(
+    const ProductCache& productCache, const ItemQuery& query, const bool paginate) const {
+  ItemSelection selection;
+  const size_t offset = paginate ? query.offset : 0;
+  const size_t limit = paginate ? query.limit : 0;
+
+  if (!query.text.empty()) {
+    // Ranked order has no stable key to resume from, so pages use offset.
+    const auto keep = limit > 0 ? offset + limit : 0;
+    auto ranked = SearchItems(productCache, query, keep, selection.total);
+    if (offset < ranked.size()) {
+      selection.slots.assign(ranked.begin() + static_cast<std::ptrdiff_t>(offset), ranked.end());
+    }
+  } else {
+    const auto byId = SlotsById(productCache);
+    auto it = byId->begin();
+    if (paginate && !query.cursor.empty()) {
+      it = std::upper_bound(it, byId->end(), query.cursor,
+                            [&](const std::string& cursor, const size_t slot) {
+                              return cursor < productCache.allItems[slot]->id;
+                            });
+    }
+    // Keeps counting after the page fills so total covers every match.
+    for (; it != byId->end(); ++it) {
+      if (!MatchesFilters(*productCache.allItems[*it], query)) {
+        continue;
+      }
+      const auto position = selection.total++;
+      if (position >= offset && (limit == 0 || position < offset + limit)) {
+        selection.slots.push_back(*it);
+      }
+    }
+  }
+
+  if (paginate && offset + selection.slots.size() < selection.total) {
+    selection.nextOffset = offset + selection.slots.size();
+    if (query.text.empty() && !selection.slots.empty()) {
+      selection.nextCursor = productCache.allItems[selection.slots.back()]->id;
+    }
+  }
+  return selection;
+}
+
+void BacklogWebviewService::FinishRecord(ItemRecord& item) {
+  item.createdAt = ParseTimestamp(item.created);
+  item.updatedAt = ParseTimestamp(item.updated);
+}
+
+const char* BacklogWebviewService::LaneName(const KanbanLane lane) {
+  switch (lane) {
+    case KanbanLane::Doing:
+      return "Doing";
+    case KanbanLane::Blocked:
+      return "Blocked";
+    case KanbanLane::Review:
+      return "Review";
+    case KanbanLane::Done:
+      return "Done";
+    case KanbanLane::Backlog:
+      break;
+  }
+  return "Backlog";
+}
+
+std::optional<KanbanLane> BacklogWebviewService::LaneFromName(const std::string_view name) {
+  for (size_t lane = 0; lane < kKanbanLaneCount; ++lane) {
+    if (text::EqualsIgnoreCase(name, LaneName(static_cast<KanbanLane>(lane)))) {
+      return static_cast<KanbanLane>(lane);
+    }
+  }
+  return std::nullopt;
+}
+
+struct BacklogWebviewService::ItemStreamState {
+  enum class Phase { Head, Items, Tail, Done };
+
+  std::shared_ptr<const ProductCache> snapshot;
+  StreamFormat format = StreamFormat::Json;
+  std::uint32_t fields = kAllItemFields;
+  ItemSelection selection;
+  size_t next = 0;
+  Phase phase = Phase::Head;
+  std::string pending;
+  size_t offset = 0;
+};
+
+std::shared_ptr<BacklogWebviewService::ItemStreamState> BacklogWebviewService::OpenItemStream(
+    std::shared_ptr<const ProductCache> snapshot, const ItemQuery& query,
+    const StreamFormat format) const {
+  auto state = std::make_shared<ItemStreamState>();
+  state->format = format;
+  state->fields = FieldMask(query);
+  state->selection = SelectItems(*snapshot, query, true);
+  state->snapshot = std::move(snapshot);
+  return state;
+}
+
+// Same members and key order as the jsoncpp tree FillItemsData builds.
+bool BacklogWebviewService::NextItemChunk(ItemStreamState& state) {
+  using Phase = ItemStreamState::Phase;
+  const bool json = state.format == StreamFormat::Json;
+  const auto& productCache = *state.snapshot;
+  const auto& selection = state.selection;
+  auto& out = state.pending;
+
+  switch (state.phase) {
+    case Phase::Head:
+      if (json) {
+        out += "{\"cached_at\":";
+        AppendJsonString(out, ToIsoString(productCache.latestMtime));
+        out += ",\"items\":[";
+      }
+      state.phase = Phase::Items;
+      return true;
+    case Phase::Items: {
+      // Relative to the current size so the memo can accumulate in pending.
+      const auto stop = out.size() + kStreamChunkBytes;
+      while (state.next < selection.slots.size() && out.size() < stop) {
+        if (json && state.next > 0) {
+          out.push_back(',');
+        }
+        AppendListedItem(out, productCache, selection.slots[state.next++], state.fields);
+        if (!json) {
+          out.push_back('\n');
+        }
+      }
+      if (state.next == selection.slots.size()) {
+        state.phase = Phase::Tail;
+      }
+      return true;
+    }
+    case Phase::Tail:
+      if (json) {
+        out += ']';
+        if (!selection.nextCursor.empty()) {
+          out += ",\"next_cursor\":";
+          AppendJsonString(out, selection.nextCursor);
+        }
+        if (selection.nextOffset > 0) {
+          out += ",\"next_offset\":" + std::to_string(selection.nextOffset);
+        }
+        out += ",\"total\":" + std::to_string(selection.total);
+        out += ",\"warnings\":[";
+        for (size_t i = 0; i < productCache.warnings.size(); ++i) {
+          if (i > 0) {
+            out.push_back(',');
+          }
+          AppendJsonString(out, productCache.warnings[i]);
+        }
+        out += "]}";
+      }
+      state.phase = Phase::Done;
+      return true;
+    case Phase::Done:
+      break;
+  }
+  return false;
+}
+
+// Mirrors ListedItemJson; members are written in jsoncpp's sorted order.
+void BacklogWebviewService::AppendListedItem(std::string& out,
+                                             const ProductCache& productCache,
+                                             const size_t primaryIndex,
+                                             const std::uint32_t fields) {
+  const auto& item = *productCache.allItems[primaryIndex];
+  char separator = '{';
+  const auto key = [&](const char* name) {
+    out.push_back(separator);
+    separator = ',';
+    out.push_back('"');
+    out += name;
+    out += "\":";
+  };
+  const auto field = [&](const std::uint32_t bit, const char* name, const std::string& value) {
+    if (fields & bit) {
+      key(name);
+      AppendJsonString(out, value);
+    }
+  };
+
+  field(kFieldCreated, "created", item.created);
+  if (fields & kFieldDuplicateCount) {
+    const auto duplicateIt = productCache.idIndexes.find(item.id);
+    if (duplicateIt != productCache.idIndexes.end()) {
+      key("duplicate_count");
+      out += std::to_string(duplicateIt->second.size());
+    }
+  }
+  key("id");
+  AppendJsonString(out, item.id);
+  field(kFieldParent, "parent", item.parent);
+  if (!item.parseError.empty()) {
+    field(kFieldParseError, "parse_error", item.parseError);
+  }
+  field(kFieldPath, "path", item.relativePath);
+  field(kFieldSourceKind, "source_kind", item.sourceKind.str());
+  field(kFieldState, "state", item.state.str());
+  field(kFieldTitle, "title", item.title);
+  field(kFieldType, "type", item.type.str());
+  field(kFieldUpdated, "updated", item.updated);
+  if (fields & kFieldValid) {
+    key("valid");
+    out += item.valid ? "true" : "false";
+  }
+  out.push_back('}');
+}
+
+BacklogWebviewService::StreamReader BacklogWebviewService::StreamItems(
+    const std::string& product, const ItemQuery& query, const StreamFormat format) {
+  Json::Value ignored;
+  auto snapshot = AcquireForView(product, false, ignored);
+  if (!snapshot) {
+    return {};
+  }
+  return [state = OpenItemStream(std::move(snapshot), query, format),
+          productMetrics = StateFor(product)->metrics](
+             char* buffer, const std::size_t size) mutable -> std::size_t {
+    if (!buffer) {
+      state.reset();
+      return 0;
+    }
+    if (!state) {
+      return 0;
+    }
+    std::size_t written = 0;
+    while (written < size) {
+      if (state->offset == state->pending.size()) {
+        state->pending.clear();
+        state->offset = 0;
+        if (!NextItemChunk(*state)) {
+          break;
+        }
+        continue;
+      }
+      const auto count = std::min(size - written, state->pending.size() - state->offset);
+      std::memcpy(buffer + written, state->pending.data() + state->offset, count);
+      state->offset += count;
+      written += count;
+    }
+    productMetrics->bytesSerialized.fetch_add(written, std::memory_order_relaxed);
+    return written;
+  };
+}
+
+void BacklogWebviewService::FillViewData(const View view, const ProductCache& productCache,
+                                         const ItemQuery& query,
+                                         Json::Value& response) const {
+  switch (view) {
+    case View::Items:
+      FillItemsData(productCache, query, response);
+      break;
+    case View::Tree:
+      FillTreeData(productCache, response);
+      break;
+    case View::Kanban:
+      FillKanbanData(productCache, query, response);
+      break;
+  }
+}
+
+void BacklogWebviewService::FillItemsData(const ProductCache& productCache,
+                                          const ItemQuery& query,
+                                          Json::Value& response) const {
+  for (const auto& warning : productCache.warnings) {
+    response["warnings"].append(warning);
+  }
+
+  const auto selection = SelectItems(productCache, query, true);
+  const auto fields = FieldMask(query);
+  for (const auto primaryIndex : selection.slots) {
+    response["items"].append(ListedItemJson(productCache, primaryIndex, fields));
+  }
+  response["total"] = static_cast<Json::UInt64>(selection.total);
+  if (selection.nextOffset > 0) {
+    response["next_offset"] = static_cast<Json::UInt64>(selection.nextOffset);
+  }
+  if (!selection.nextCursor.empty()) {
+    response["next_cursor"] = selection.nextCursor;
+  }
+
+  response["cached_at"] = ToIsoString(productCache.latestMtime);
+}
+
+std::vector<size_t> BacklogWebviewService::SearchItems(const ProductCache& productCache,
+                                                       const ItemQuery& query,
+                                                       const size_t keep,
+                                                       size_t& total) const {
+  // Bodies not resident (lazy mode, index restore) are read straight from
+  // disk so indexing does not flush the GetItem content cache.
+  std::string buffer;
+  const auto withBody = [&buffer](const ItemRecord& item, const auto& visit) {
+    if (!item.bodyOnDisk) {
+      visit(item.rawContent);
+      return;
+    }
+    std::string error;
+    ReadTextFile(item.contentPath, buffer, error);
+    visit(buffer);
+  };
+
+  auto& memo = productCache.search;
+  std::shared_ptr<const SearchIndex> titles;
+  std::shared_ptr<const TrigramPostings> bodies;
+  {
+    // Built once per snapshot; concurrent first queries wait for it.
+    std::lock_guard lock(memo.mutex);
+    if (!memo.titles) {
+      auto index = std::make_shared<SearchIndex>();
+      for (const auto& [id, primaryIndex] : productCache.primaryById) {
+        index->Add(primaryIndex, id, productCache.allItems[primaryIndex]->title);
+      }
+      index->Finalize();
+      memo.titles = std::move(index);
+    }
+    if (query.searchBody && !memo.bodies) {
+      auto postings = std::make_shared<TrigramPostings>();
+      for (std::uint32_t doc = 0; doc < memo.titles->Size(); ++doc) {
+        withBody(*productCache.allItems[memo.titles->Key(doc)],
+                 [&](const std::string& body) { postings->Add(doc, text::ToLower(body)); });
+      }
+      postings->Finalize();
+      memo.bodies = std::move(postings);
+    }
+    titles = memo.titles;
+    bodies = query.searchBody ? memo.bodies : nullptr;
+  }
+
+  SearchIndex::Options options;
+  options.limit = keep;
+  if (!query.types.empty() || !query.states.empty() || query.parent) {
+    options.accept = [&](const size_t slot) {
+      return MatchesFilters(*productCache.allItems[slot], query);
+    };
+  }
+  options.bodies = bodies.get();
+  options.bodyContains = [&](const std::uint32_t doc, const std::string_view loweredQuery) {
+    bool found = false;
+    withBody(*productCache.allItems[titles->Key(doc)], [&](const std::string& body) {
+      found = text::ContainsCaseInsensitive(body, loweredQuery);
+    });
+    return found;
+  };
+  auto result = titles->Search(query.text, options);
+  total = result.total;
+  return std::move(result.keys);
+}
+
+bool BacklogWebviewService::IsTreeType(const std::string& type) {
+  return type == "Epic" || type == "Feature" || type == "UserStory" || type == "Task" ||
+         type == "Bug" || type == "Theme";
+}
+
+std::shared_ptr<const BacklogWebviewService::Hierarchy> BacklogWebviewService::BuildHierarchy(
+    const ProductCache& productCache) {
+  constexpr auto kNoNode = Hierarchy::kNoNode;
+  auto hierarchy = std::make_shared<Hierarchy>();
+  auto& slots = hierarchy->slots;
+  const auto idOf = [&](const std::uint32_t node) -> const std::string& {
+    return productCache.allItems[slots[node]]->id;
+  };
+
+  for (const auto& [id, primaryIndex] : productCache.primaryById) {
+    const auto& item = *productCache.allItems[primaryIndex];
+    if (IsTreeType(item.type.str()) && !item.id.empty()) {
+      slots.push_back(primaryIndex);
+    }
+  }
+  std::sort(slots.begin(), slots.end(), [&](const size_t left, const size_t right) {
+    return productCache.allItems[left]->id < productCache.allItems[right]->id;
+  });
+  const auto nodeCount = static_cast<std::uint32_t>(slots.size());
+  const auto findNode = [&](const std::string& id) {
+    const auto it = std::lower_bound(slots.begin(), slots.end(), id,
+                                     [&](const size_t slot, const std::string& value) {
+                                       return productCache.allItems[slot]->id < value;
+                                     });
+    return it != slots.end() && productCache.allItems[*it]->id == id
+               ? static_cast<std::uint32_t>(it - slots.begin())
+               : kNoNode;
+  };
+
+  // Children are counted, then placed; walking nodes in id order keeps each
+  // child list id-sorted.
+  hierarchy->parents.assign(nodeCount, kNoNode);
+  hierarchy->childBegin.assign(nodeCount + 1, 0);
+  for (std::uint32_t node = 0; node < nodeCount; ++node) {
+    const auto& parentId = productCache.allItems[slots[node]]->parent;
+    if (parentId.empty()) {
+      continue;
+    }
+    const auto parent = findNode(parentId);
+    if (parent == kNoNode) {
+      hierarchy->warnings.push_back("Orphan parent missing for item " + idOf(node) + ": " +
+                                    parentId);
+      continue;
+    }
+    hierarchy->parents[node] = parent;
+    ++hierarchy->childBegin[parent + 1];
+  }
+  for (std::uint32_t node = 0; node < nodeCount; ++node) {
+    hierarchy->childBegin[node + 1] += hierarchy->childBegin[node];
+  }
+  hierarchy->children.resize(hierarchy->childBegin[nodeCount]);
+  std::vector<std::uint32_t> fill(hierarchy->childBegin.begin(),
+                                  hierarchy->childBegin.end() - 1);
+  for (std::uint32_t node = 0; node < nodeCount; ++node) {
+    if (const auto parent = hierarchy->parents[node]; parent != kNoNode) {
+      hierarchy->children[fill[parent]++] = node;
+    } else {
+      hierarchy->roots.push_back(node);
+    }
+  }
+
+  // Nodes not reachable from a root sit on or below a parent cycle. Each
+  // cycle is reported once, at its smallest id, and left out of the tree.
+  std::vector<std::uint8_t> reached(nodeCount, 0);
+  std::vector<std::uint32_t> stack(hierarchy->roots.begin(), hierarchy->roots.end());
+  while (!stack.empty()) {
+    const auto node = stack.back();
+    stack.pop_back();
+    reached[node] = 1;
+    for (auto i = hierarchy->childBegin[node]; i < hierarchy->childBegin[node + 1]; ++i) {
+      stack.push_back(hierarchy->children[i]);
+    }
+  }
+  hierarchy->inTree.assign(reached.begin(), reached.end());
+  std::vector<std::uint32_t> cycleEntries;
+  for (std::uint32_t node = 0; node < nodeCount; ++node) {
+    if (reached[node]) {
+      continue;
+    }
+    // Walk up to the cycle, marking the path so later walks stop early.
+    std::vector<std::uint32_t> path;
+    auto current = node;
+    while (!reached[current]) {
+      reached[current] = 2;
+      path.push_back(current);
+      current = hierarchy->parents[current];
+    }
+    const auto entered = std::find(path.begin(), path.end(), current);
+    if (reached[current] == 2 && entered != path.end()) {
+      cycleEntries.push_back(*std::min_element(entered, path.end()));
+    }
+  }
+  std::sort(cycleEntries.begin(), cycleEntries.end());
+  for (const auto node : cycleEntries) {
+    hierarchy->warnings.push_back("Cycle detected at " + idOf(node));
+  }
+  return hierarchy;
+}
+
+void BacklogWebviewService::FillTreeData(const ProductCache& productCache,
+                                         Json::Value& response) {
+  if (const auto& hierarchy = productCache.hierarchy) {
+    // Nodes are filled in place; jsoncpp keeps member references stable.
+    std::vector<Json::Value*> open;
+    open.push_back(&response["roots"]);
+    WalkHierarchy(
+        *hierarchy, hierarchy->roots, 0,
+        [&](const std::uint32_t node) {
+          const auto& item = *productCache.allItems[hierarchy->slots[node]];
+          auto& value = open.back()->append(Json::Value(Json::objectValue));
+          value["id"] = item.id;
+          value["title"] = item.title;
+          value["type"] = item.type.str();
+          value["state"] = item.state.str();
+          value["parent"] = item.parent;
+          open.push_back(&(value["children"] = Json::arrayValue));
+        },
+        [&](std::uint32_t) { open.pop_back(); });
+    for (const auto& warning : hierarchy->warnings) {
+      response["warnings"].append(warning);
+    }
+  }
+
+  for (const auto& warning : productCache.warnings) {
+    response["warnings"].append(warning);
+  }
+}
+
+// Same bytes as SerializeCompact over FillTreeData.
+void BacklogWebviewService::AppendTreeData(std::string& out, const ProductCache& productCache) {
+  out += "{\"roots\":";
+  const auto& hierarchy = productCache.hierarchy;
+  AppendTreeNodes(out, productCache, hierarchy ? hierarchy->roots : std::vector<std::uint32_t>(),
+                  0, false);
+  out += ",\"warnings\":[";
+  bool first = true;
+  const auto appendWarning = [&](const std::string& warning) {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    AppendJsonString(out, warning);
+  };
+  if (hierarchy) {
+    std::for_each(hierarchy->warnings.begin(), hierarchy->warnings.end(), appendWarning);
+  }
+  std::for_each(productCache.warnings.begin(), productCache.warnings.end(), appendWarning);
+  out += "]}";
+}
+
+// Node members are in jsoncpp's sorted order, so children come before id.
+void BacklogWebviewService::AppendTreeNodes(std::string& out, const ProductCache& productCache,
+                                            const std::vector<std::uint32_t>& starts,
+                                            const size_t maxDepth, const bool withChildCount) {
+  out.push_back('[');
+  const auto& hierarchy = productCache.hierarchy;
+  if (hierarchy) {
+    std::vector<bool> needsComma{false};
+    WalkHierarchy(
+        *hierarchy, starts, maxDepth,
+        [&](const std::uint32_t node) {
+          if (needsComma.back()) {
+            out.push_back(',');
+          }
+          needsComma.back() = true;
+          needsComma.push_back(false);
+          if (withChildCount) {
+            out += "{\"child_count\":";
+            out += std::to_string(hierarchy->childBegin[node + 1] - hierarchy->childBegin[node]);
+            out += ",\"children\":[";
+          } else {
+            out += "{\"children\":[";
+          }
+        },
+        [&](const std::uint32_t node) {
+          const auto& item = *productCache.allItems[hierarchy->slots[node]];
+          needsComma.pop_back();
+          out += "],\"id\":";
+          AppendJsonString(out, item.id);
+          out += ",\"parent\":";
+          AppendJsonString(out, item.parent);
+          out += ",\"state\":";
+          AppendJsonString(out, item.state.str());
+          out += ",\"title\":";
+          AppendJsonString(out, item.title);
+          out += ",\"type\":";
+          AppendJsonString(out, item.type.str());
+          out.push_back('}');
+        });
+  }
+  out.push_back(']');
+}
+
+std::uint32_t BacklogWebviewService::FindTreeNode(const ProductCache& productCache,
+                                                  const std::string& id) {
+  const auto& hierarchy = productCache.hierarchy;
+  if (!hierarchy) {
+    return Hierarchy::kNoNode;
+  }
+  const auto& slots = hierarchy->slots;
+  const auto it = std::lower_bound(slots.begin(), slots.end(), id,
+                                   [&](const size_t slot, const std::string& value) {
+                                     return productCache.allItems[slot]->id < value;
+                                   });
+  if (it == slots.end() || productCache.allItems[*it]->id != id) {
+    return Hierarchy::kNoNode;
+  }
+  const auto node = static_cast<std::uint32_t>(it - slots.begin());
+  return hierarchy->inTree[node] ? node : Hierarchy::kNoNode;
+}
+
+std::filesystem::path BacklogWebviewService::LaneMapPath(const ProductState& state) {
+  return state.productRoot / "_config" / "kanban.json";
+}
+
+std::shared_ptr<const BacklogWebviewService::LaneMap> BacklogWebviewService::LoadLaneMap(
+    const std::filesystem::path& path, std::vector<std::string>& warnings) {
+  auto laneMap = std::make_shared<LaneMap>(LaneMap{
+      {"inprogress", KanbanLane::Doing},
+      {"active", KanbanLane::Doing},
+      {"blocked", KanbanLane::Blocked},
+      {"review", KanbanLane::Review},
+      {"done", KanbanLane::Done},
+      {"closed", KanbanLane::Done},
+  });
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return laneMap;
+  }
+  const auto invalid = [&](const std::string& reason) {
+    warnings.push_back("Invalid lane map " + path.generic_string() + ": " + reason);
+  };
+  std::string content;
+  bool ok = false;
+  std::string error;
+  const auto root = ParseJsonFile(path, content, ok, error);
+  if (!ok) {
+    invalid(error);
+    return laneMap;
+  }
+  if (!root.isObject() || !root["lanes"].isObject()) {
+    invalid("expected {\"lanes\": {\"<lane>\": [\"<state>\", ...]}}");
+    return laneMap;
+  }
+  const auto& lanes = root["lanes"];
+  for (const auto& name : lanes.getMemberNames()) {
+    const auto lane = LaneFromName(name);
+    const auto& states = lanes[name];
+    if (!lane) {
+      invalid("unknown lane " + name);
+      continue;
+    }
+    if (!states.isArray()) {
+      invalid("lane " + name + " is not a list of states");
+      continue;
+    }
+    for (const auto& state : states) {
+      if (state.isString()) {
+        (*laneMap)[text::ToLower(state.asString())] = *lane;
+      } else {
+        invalid("lane " + name + " lists a non-string state");
+      }
+    }
+  }
+  return laneMap;
+}
+
+std::shared_ptr<const BacklogWebviewService::KanbanIndex>
+BacklogWebviewService::BuildKanbanIndex(const ProductCache& productCache,
+                                        const LaneMap& laneMap,
+                                        std::vector<std::string> warnings) {
+  auto index = std::make_shared<KanbanIndex>();
+  index->warnings = std::move(warnings);
+  index->laneBySlot.assign(productCache.allItems.size(), KanbanLane::Backlog);
+  // Types and states are pooled, so each distinct one is resolved once.
+  std::unordered_map<const std::string*, KanbanLane> laneByState;
+  std::unordered_map<const std::string*, size_t> typeEntry;
+  for (const auto slot : *SlotsById(productCache)) {
+    const auto& item = *productCache.allItems[slot];
+    auto stateIt = laneByState.find(&item.state.str());
+    if (stateIt == laneByState.end()) {
+      const auto it = laneMap.find(text::ToLower(item.state.str()));
+      stateIt = laneByState
+                    .emplace(&item.state.str(),
+                             it == laneMap.end() ? KanbanLane::Backlog : it->second)
+                    .first;
+    }
+    const auto lane = static_cast<size_t>(stateIt->second);
+    auto typeIt = typeEntry.find(&item.type.str());
+    if (typeIt == typeEntry.end()) {
+      typeIt = typeEntry.emplace(&item.type.str(), index->byType.size()).first;
+      index->byType.emplace_back(item.type, KanbanIndex::LaneSlots{});
+    }
+    index->laneBySlot[slot] = stateIt->second;
+    index->slots[lane].push_back(slot);
+    index->byType[typeIt->second].second[lane].push_back(slot);
+  }
+  std::sort(index->byType.begin(), index->byType.end(),
+            [](const auto& left, const auto& right) {
+              return left.first.str() < right.first.str();
+            });
+  return index;
+}
+
+void BacklogWebviewService::FillKanbanData(const ProductCache& productCache,
+                                           const ItemQuery& query,
+                                           Json::Value& response) const {
+  const auto fields = FieldMask(query);
+  auto& lanes = response["lanes"];
+  auto& totals = response["totals"];
+  auto& typeTotals = response["type_totals"];
+  const auto typeCounts = [&](const std::string& type) -> Json::Value& {
+    auto& counts = typeTotals[type];
+    if (counts.isNull()) {
+      for (size_t lane = 0; lane < kKanbanLaneCount; ++lane) {
+        counts[LaneName(static_cast<KanbanLane>(lane))] = 0;
+      }
+    }
+    return counts;
+  };
+  const auto& index = productCache.kanban;
+  // Lanes whose items are emitted; an unknown lane name emits none.
+  const auto onlyLane = LaneFromName(query.lane);
+  const auto emitted = [&](const size_t lane) {
+    return !query.countsOnly &&
+           (query.lane.empty() || onlyLane == static_cast<KanbanLane>(lane));
+  };
+  const auto inPage = [&](const size_t position) {
+    return position >= query.offset && (query.limit == 0 || position - query.offset < query.limit);
+  };
+
+  if (index && query.text.empty() && query.states.empty() && !query.parent) {
+    // Unfiltered and type-filtered boards are read straight off the index.
+    std::vector<const KanbanIndex::LaneSlots*> sources;
+    if (query.types.empty()) {
+      sources.push_back(&index->slots);
+    }
+    for (const auto& [type, slots] : index->byType) {
+      if (!query.types.empty() &&
+          std::find(query.types.begin(), query.types.end(), type.str()) == query.types.end()) {
+        continue;
+      }
+      if (!query.types.empty()) {
+        sources.push_back(&slots);
+      }
+      auto& counts = typeCounts(type.str());
+      for (size_t lane = 0; lane < kKanbanLaneCount; ++lane) {
+        counts[LaneName(static_cast<KanbanLane>(lane))] = Json::UInt64(slots[lane].size());
+      }
+    }
+    for (size_t lane = 0; lane < kKanbanLaneCount; ++lane) {
+      const auto* name = LaneName(static_cast<KanbanLane>(lane));
+      size_t total = 0;
+      for (const auto* source : sources) {
+        total += (*source)[lane].size();
+      }
+      totals[name] = Json::UInt64(total);
+      if (!emitted(lane)) {
+        continue;
+      }
+      const size_t end = query.limit == 0 ? total : std::min(total, query.offset + query.limit);
+      if (sources.size() == 1) {
+        const auto& slots = (*sources.front())[lane];
+        for (size_t position = query.offset; position < end; ++position) {
+          lanes[name].append(ListedItemJson(productCache, slots[position], fields));
+        }
+        continue;
+      }
+      // Several types are merged back into id order, up to the page end.
+      std::vector<size_t> next(sources.size(), 0);
+      for (size_t position = 0; position < end; ++position) {
+        size_t best = sources.size();
+        for (size_t source = 0; source < sources.size(); ++source) {
+          const auto& slots = (*sources[source])[lane];
+          if (next[source] < slots.size() &&
+              (best == sources.size() ||
+               productCache.allItems[slots[next[source]]]->id <
+                   productCache.allItems[(*sources[best])[lane][next[best]]]->id)) {
+            best = source;
+          }
+        }
+        const auto slot = (*sources[best])[lane][next[best]++];
+        if (position >= query.offset) {
+          lanes[name].append(ListedItemJson(productCache, slot, fields));
+        }
+      }
+    }
+  } else {
+    for (const auto primaryIndex : SelectItems(productCache, query, false).slots) {
+      const auto lane = index ? index->laneBySlot[primaryIndex] : KanbanLane::Backlog;
+      const auto* name = LaneName(lane);
+      auto& total = totals[name];
+      const auto position = static_cast<size_t>(total.asUInt64());
+      total = Json::UInt64(position + 1);
+      auto& typeTotal = typeCounts(productCache.allItems[primaryIndex]->type.str())[name];
+      typeTotal = typeTotal.asUInt64() + 1;
+      if (emitted(static_cast<size_t>(lane)) && inPage(position)) {
+        lanes[name].append(ListedItemJson(productCache, primaryIndex, fields));
+      }
+    }
+  }
+
+  if (index) {
+    for (const auto& warning : index->warnings) {
+      response["warnings"].append(warning);
+    }
+  }
+  for (const auto& warning : productCache.warnings) {
+    response["warnings"].append(warning);
+  }
+}
+
+Json::Value BacklogWebviewService::ListItems(const std::string& product,
+                                             bool forceRefresh) {
+  auto response = EmptyViewData(View::Items);
+  if (const auto snapshot = AcquireForView(product, forceRefresh, response)) {
+    FillItemsData(*snapshot, {}, response);
+  }
+  return response;
+}
+
+Json::Value BacklogWebviewService::BuildTree(const std::string& product,
+                                             bool forceRefresh) {
+  auto response = EmptyViewData(View::Tree);
+  if (const auto snapshot = AcquireForView(product, forceRefresh, response)) {
+    FillTreeData(*snapshot, response);
+  }
+  return response;
+}
+
+Json::Value BacklogWebviewService::BuildKanban(const std::string& product,
+                                               bool forceRefresh) {
+  auto response = EmptyViewData(View::Kanban);
+  if (const auto snapshot = AcquireForView(product, forceRefresh, response)) {
+    FillKanbanData(*snapshot, {}, response);
+  }
+  return response;
+}
+
+BacklogWebviewService::SerializedView BacklogWebviewService::GetSerializedView(
+    const std::string& product, const View view, const ItemQuery& query, const bool gzip) {
+  SerializedView result;
+  auto response = EmptyViewData(view);
+  const auto snapshot = AcquireForView(product, false, response);
+  if (!snapshot) {
+    result.data = std::make_shared<const std::string>(SerializeCompact(response));
+    return result;
+  }
+
+  result.ok = true;
+  const auto effectiveQuery = view == View::Tree ? ItemQuery() : query;
+  auto memoKey = std::to_string(static_cast<int>(view));
+  memoKey.push_back('\n');
+  memoKey += ItemQueryKey(effectiveQuery);
+  result.etag = ViewEtag(snapshot->generation, memoKey);
+  auto& productMetrics = *StateFor(product)->metrics;
+  {
+    std::lock_guard lock(snapshot->views.mutex);
+    const auto memoIt = snapshot->views.bodies.find(memoKey);
+    if (memoIt != snapshot->views.bodies.end()) {
+      result.data = memoIt->second;
+      productMetrics.viewHits.fetch_add(1, std::memory_order_relaxed);
+      if (gzip) {
+        if (const auto gzipIt = snapshot->views.gzipHeads.find(memoKey);
+            gzipIt != snapshot->views.gzipHeads.end()) {
+          result.gzip = gzipIt->second;
+          return result;
+        }
+      } else {
+        return result;
+      }
+    }
+  }
+  if (result.data) {
+    // Memo hit whose compressed head is not built yet.
+    AttachGzip(*snapshot, memoKey, result);
+    return result;
+  }
+  productMetrics.viewMisses.fetch_add(1, std::memory_order_relaxed);
+  std::optional<ScopedTimer> serializeTimer(std::in_place, productMetrics.serialize);
+
+  // Built outside the memo lock; a concurrent miss may serialize the same
+  // view twice, and the first body stored wins. Items and Tree skip the
+  // jsoncpp tree.
+  if (view == View::Items) {
+    const auto stream = OpenItemStream(snapshot, effectiveQuery, StreamFormat::Json);
+    while (NextItemChunk(*stream)) {
+    }
+    result.data = std::make_shared<const std::string>(std::move(stream->pending));
+  } else if (view == View::Tree) {
+    std::string body;
+    AppendTreeData(body, *snapshot);
+    result.data = std::make_shared<const std::string>(std::move(body));
+  } else {
+    FillViewData(view, *snapshot, effectiveQuery, response);
+    result.data = std::make_shared<const std::string>(SerializeCompact(response));
+  }
+  serializeTimer.reset();
+  productMetrics.bytesSerialized.fetch_add(result.data->size(), std::memory_order_relaxed);
+  {
+    std::lock_guard lock(snapshot->views.mutex);
+    if (snapshot->views.bodies.size() < kMaxMemoizedViews) {
+      const auto [it, inserted] = snapshot->views.bodies.emplace(memoKey, result.data);
+      if (inserted) {
+        snapshot->views.bytes += result.data->size();
+      }
+      result.data = it->second;
+    }
+  }
+  if (gzip) {
+    AttachGzip(*snapshot, memoKey, result);
   }
+  return result;
+}
 
-  LoadProduct(product, forceRefresh);
-  const auto cacheIt = cacheByProduct.find(product);
-  if (cacheIt == cacheByProduct.end()) {
-    response["error"] = "Product not found";
-    return response;
+void BacklogWebviewService::AttachGzip(const ProductCache& productCache,
+                                       const std::string& memoKey, SerializedView& view) {
+  if (view.data->size() < kMinGzipBytes) {
+    return;
+  }
+  // Compressed outside the lock like the body; a body that did not make it
+  // into the memo is compressed for this response only.
+  std::string head(kEnvelopeHead);
+  head += *view.data;
+  auto compressed = std::make_shared<const GzipPrefix>(GzipCompressPrefix(head));
+  std::lock_guard lock(productCache.views.mutex);
+  const auto bodyIt = productCache.views.bodies.find(memoKey);
+  if (bodyIt == productCache.views.bodies.end() || bodyIt->second != view.data) {
+    view.gzip = std::move(compressed);
+    return;
+  }
+  const auto [it, inserted] = productCache.views.gzipHeads.emplace(memoKey, std::move(compressed));
+  if (inserted) {
+    productCache.views.bytes += it->second->bytes.size();
   }
+  view.gzip = it->second;
+}
 
-  const auto& productCache = cacheIt->second;
-  for (const auto& warning : productCache.warnings) {
-    response["warnings"].append(warning);
+BacklogWebviewService::SerializedView BacklogWebviewService::GetTreeChildren(
+    const std::string& product, const std::string& id, const size_t depth, const size_t offset,
+    const size_t limit) {
+  SerializedView result;
+  Json::Value response(Json::objectValue);
+  response["id"] = id;
+  response["nodes"] = Json::arrayValue;
+  const auto snapshot = AcquireForView(product, false, response);
+  if (!snapshot) {
+    result.data = std::make_shared<const std::string>(SerializeCompact(response));
+    return result;
   }
 
-  for (const auto& [id, primaryIndex] : productCache.primaryById) {
-    const auto& item = productCache.allItems[primaryIndex];
-    auto value = ItemToJson(item);
-    const auto duplicateIt = productCache.idIndexes.find(id);
-    if (duplicateIt != productCache.idIndexes.end()) {
-      value["duplicate_count"] =
-          static_cast<Json::UInt64>(duplicateIt->second.size());
+  std::vector<std::uint32_t> starts;
+  if (id.empty()) {
+    if (snapshot->hierarchy) {
+      starts = snapshot->hierarchy->roots;
+    }
+  } else {
+    const auto node = FindTreeNode(*snapshot, id);
+    if (node == Hierarchy::kNoNode) {
+      response["error"] = "Node not found";
+      result.notFound = true;
+      result.data = std::make_shared<const std::string>(SerializeCompact(response));
+      return result;
     }
-    response["items"].append(value);
+    const auto& hierarchy = *snapshot->hierarchy;
+    starts.assign(hierarchy.children.begin() + hierarchy.childBegin[node],
+                  hierarchy.children.begin() + hierarchy.childBegin[node + 1]);
+  }
+
+  const auto total = starts.size();
+  starts.erase(starts.begin(), starts.begin() + static_cast<std::ptrdiff_t>(std::min(offset, total)));
+  if (limit > 0 && starts.size() > limit) {
+    starts.resize(limit);
+  }
+  const auto nextOffset = offset + starts.size() < total ? offset + starts.size() : 0;
+
+  result.ok = true;
+  result.etag = ViewEtag(snapshot->generation, "children\n" + std::to_string(depth) + '\n' +
+                                                   std::to_string(offset) + ',' +
+                                                   std::to_string(limit) + '\n' + id);
+  auto& productMetrics = *StateFor(product)->metrics;
+  std::string body;
+  {
+    ScopedTimer serializeTimer(productMetrics.serialize);
+    body = "{\"id\":";
+    AppendJsonString(body, id);
+    body += ",\"total\":" + std::to_string(total);
+    if (nextOffset > 0) {
+      body += ",\"next_offset\":" + std::to_string(nextOffset);
+    }
+    body += ",\"nodes\":";
+    AppendTreeNodes(body, *snapshot, starts, depth, true);
+    body.push_back('}');
   }
-
-  response["cached_at"] = ToIsoString(productCache.latestMtime);
-  return response;
+  productMetrics.bytesSerialized.fetch_add(body.size(), std::memory_order_relaxed);
+  result.data = std::make_shared<const std::string>(std::move(body));
+  return result;
 }
 
 Json::Value BacklogWebviewService::GetItem(const std::string& product,
@@ -703,232 +3010,753 @@ Json::Value BacklogWebviewService::GetItem(const std::string& product,
     return response;
   }
 
-  LoadProduct(product, forceRefresh);
-  const auto cacheIt = cacheByProduct.find(product);
-  if (cacheIt == cacheByProduct.end()) {
+  const auto snapshot = AcquireProduct(product, forceRefresh);
+  if (!snapshot) {
     response["error"] = "Product not found";
     return response;
   }
 
-  const auto& productCache = cacheIt->second;
+  const auto& productCache = *snapshot;
   const auto primaryIt = productCache.primaryById.find(id);
   if (primaryIt == productCache.primaryById.end()) {
     response["error"] = "Item not found";
     return response;
   }
 
-  response["item"] = ItemToJson(productCache.allItems[primaryIt->second], true);
+  const auto& item = *productCache.allItems[primaryIt->second];
+  response["item"] = ItemToJson(item);
+  response["item"]["content"] = ItemContent(item);
   response["duplicates"] = Json::arrayValue;
   const auto allIt = productCache.idIndexes.find(id);
   if (allIt != productCache.idIndexes.end()) {
     for (const auto index : allIt->second) {
-      response["duplicates"].append(ItemToJson(productCache.allItems[index]));
+      response["duplicates"].append(ItemToJson(*productCache.allItems[index]));
     }
   }
   return response;
 }
 
-Json::Value BacklogWebviewService::BuildTree(const std::string& product,
-                                             bool forceRefresh) {
+Json::Value BacklogWebviewService::GetItems(const std::string& product,
+                                            const std::vector<std::string>& ids,
+                                            const bool includeContent, const bool forceRefresh) {
   Json::Value response(Json::objectValue);
-  response["roots"] = Json::arrayValue;
-  response["warnings"] = Json::arrayValue;
-
-  auto itemsResponse = ListItems(product, forceRefresh);
-  if (itemsResponse.isMember("error")) {
-    response["error"] = itemsResponse["error"];
+  if (!IsValidProductName(product)) {
+    response["error"] = "Invalid product name";
+    return response;
+  }
+  if (ids.size() > kMaxBatchItems) {
+    response["error"] = "Too many ids (at most " + std::to_string(kMaxBatchItems) + ")";
     return response;
   }
 
-  std::unordered_map<std::string, Json::Value> byId;
-  std::unordered_map<std::string, std::vector<std::string>> childIds;
-  std::set<std::string> allIds;
+  const auto snapshot = AcquireProduct(product, forceRefresh);
+  if (!snapshot) {
+    response["error"] = "Product not found";
+    return response;
+  }
 
-  for (const auto& item : itemsResponse["items"]) {
-    const auto type = item["type"].asString();
-    if (type != "Epic" && type != "Feature" && type != "UserStory" &&
-        type != "Task" && type != "Bug" && type != "Theme") {
+  const auto& productCache = *snapshot;
+  auto& items = response["items"] = Json::arrayValue;
+  auto& missing = response["missing"] = Json::arrayValue;
+  std::unordered_set<std::string_view> seen;
+  for (const auto& id : ids) {
+    if (!seen.insert(id).second) {
       continue;
     }
-    const auto id = item["id"].asString();
-    if (id.empty()) {
+    const auto primaryIt = productCache.primaryById.find(id);
+    if (primaryIt == productCache.primaryById.end()) {
+      missing.append(id);
       continue;
     }
-    allIds.insert(id);
-    Json::Value node(Json::objectValue);
-    node["id"] = id;
-    node["title"] = item["title"].asString();
-    node["type"] = item["type"].asString();
-    node["state"] = item["state"].asString();
-    node["parent"] = item["parent"].asString();
-    node["children"] = Json::arrayValue;
-    byId[id] = node;
-  }
-
-  for (const auto& item : itemsResponse["items"]) {
-    const auto type = item["type"].asString();
-    if (type != "Epic" && type != "Feature" && type != "UserStory" &&
-        type != "Task" && type != "Bug" && type != "Theme") {
-      continue;
+    const auto& item = *productCache.allItems[primaryIt->second];
+    auto& itemJson = items.append(ItemToJson(item));
+    if (includeContent) {
+      itemJson["content"] = ItemContent(item);
     }
-    const auto id = item["id"].asString();
-    if (id.empty()) {
-      continue;
+  }
+  return response;
+}
+
+bool BacklogWebviewService::HasProduct(const std::string& product) const {
+  if (!IsValidProductName(product)) {
+    return false;
+  }
+  std::shared_lock lock(stateMutex);
+  std::error_code ec;
+  return std::filesystem::is_directory(productsRoot / product, ec);
+}
+
+std::uint64_t BacklogWebviewService::SubscribeChanges(const std::string& product,
+                                                      ChangeSink sink) {
+  if (!HasProduct(product)) {
+    return 0;
+  }
+  return changeFeed->Subscribe(product, std::move(sink));
+}
+
+void BacklogWebviewService::UnsubscribeChanges(const std::uint64_t subscription) {
+  changeFeed->Unsubscribe(subscription);
+}
+
+void BacklogWebviewService::PollChanges(const std::string& product, const bool greet,
+                                        std::string& changes, std::string& hello) {
+  // The feed thread only peeks: it creates no loader state and leaves
+  // lastUsed alone, so an open tab does not keep its product from being
+  // parked or trimmed. Reloads the watcher or the shared generation call for
+  // run on the load executor (where a push usually leaves the next request a
+  // cache hit) and are reported by a later poll, so a slow load never holds
+  // up the other products' frames.
+  std::shared_ptr<const ProductCache> current;
+  {
+    std::shared_lock lock(stateMutex);
+    const auto it = productStates.find(product);
+    if (it != productStates.end()) {
+      current = it->second->Snapshot();
     }
-    const auto parent = item["parent"].asString();
-    if (!parent.empty()) {
-      childIds[parent].push_back(id);
-      if (!allIds.count(parent)) {
-        response["warnings"].append("Orphan parent missing for item " + id +
-                                     ": " + parent);
-      }
+  }
+  if (!current) {
+    // Not loaded (or trimmed): only a subscriber waiting for its hello is
+    // reason to load it, and that counts as a use.
+    if (greet) {
+      QueueFeedReload(product, true);
     }
+    return;
   }
+  if (!CurrentSnapshot(product)) {
+    QueueFeedReload(product, false);
+  }
+  auto& baseline = feedBaselines[product];
+  if (baseline && baseline->generation != current->generation) {
+    changes = ChangeFrame(product, *baseline, *current);
+  }
+  baseline = current;
+  if (greet) {
+    const auto generation = std::to_string(current->generation);
+    // retry: reconnect delay; the client compares the hello generation with
+    // the one it holds to catch bumps missed while disconnected.
+    hello = "retry: 2000\nid: " + generation + "\nevent: hello\ndata: {\"generation\":" +
+            generation + ",\"product\":";
+    AppendJsonString(hello, product);
+    hello += "}\n\n";
+  }
+}
 
-  std::set<std::string> visiting;
-  std::set<std::string> visited;
-  std::function<void(Json::Value&, const std::string&)> attachChildren;
-  attachChildren = [&](Json::Value& node, const std::string& nodeId) {
-    visiting.insert(nodeId);
-    visited.insert(nodeId);
-
-    for (const auto& childId : childIds[nodeId]) {
-      if (!byId.count(childId)) {
-        continue;
-      }
-      if (visiting.count(childId)) {
-        response["warnings"].append("Cycle detected at " + childId);
-        continue;
-      }
-      auto child = byId[childId];
-      attachChildren(child, childId);
-      node["children"].append(child);
+void BacklogWebviewService::QueueFeedReload(const std::string& product, const bool markUsed) {
+  {
+    std::lock_guard lock(feedReloadMutex);
+    if (!feedReloads.insert(product).second) {
+      return;
     }
+  }
+  loadExecutor->Post([this, product, markUsed] {
+    try {
+      AcquireProduct(product, false, markUsed);
+    } catch (const std::exception&) {
+      // The next poll queues it again.
+    }
+    std::lock_guard lock(feedReloadMutex);
+    feedReloads.erase(product);
+  });
+}
 
-    visiting.erase(nodeId);
+// Records are shared between snapshots, so equal pointers are unchanged and
+// only reparsed sources need a field comparison (which a forced refresh makes
+// of every record). Lazy mode holds no bodies to compare, so any reparse
+// counts as a change there.
+std::string BacklogWebviewService::ChangeFrame(const std::string& product,
+                                               const ProductCache& before,
+                                               const ProductCache& after) const {
+  const auto sameRecord = [&](const ItemRecord& left, const ItemRecord& right) {
+    return !options.lazyContent &&
+           std::tie(left.id, left.title, left.parent, left.created, left.updated,
+                    left.relativePath, left.rawContent, left.contentPath, left.valid,
+                    left.parseError) ==
+               std::tie(right.id, right.title, right.parent, right.created, right.updated,
+                        right.relativePath, right.rawContent, right.contentPath, right.valid,
+                        right.parseError) &&
+           left.type == right.type && left.sourceKind == right.sourceKind &&
+           left.state == right.state;
   };
-
-  for (const auto& item : itemsResponse["items"]) {
-    const auto type = item["type"].asString();
-    if (type != "Epic" && type != "Feature" && type != "UserStory" &&
-        type != "Task" && type != "Bug" && type != "Theme") {
+  std::vector<std::string_view> added;
+  std::vector<std::string_view> changed;
+  std::vector<std::string_view> removed;
+  for (const auto& [id, slot] : after.primaryById) {
+    const auto it = before.primaryById.find(id);
+    if (it == before.primaryById.end()) {
+      added.push_back(id);
       continue;
     }
-    const auto id = item["id"].asString();
-    if (id.empty()) {
-      continue;
+    const auto& previous = before.allItems[it->second];
+    const auto& current = after.allItems[slot];
+    if (previous != current && !sameRecord(*previous, *current)) {
+      changed.push_back(id);
     }
-    const auto parent = item["parent"].asString();
-    const bool isRoot = parent.empty() || !allIds.count(parent);
-    if (!isRoot || visited.count(id)) {
-      continue;
+  }
+  for (const auto& [id, slot] : before.primaryById) {
+    if (!after.primaryById.count(id)) {
+      removed.push_back(id);
     }
-    auto root = byId[id];
-    attachChildren(root, id);
-    response["roots"].append(root);
   }
 
-  for (const auto& warning : itemsResponse["warnings"]) {
-    response["warnings"].append(warning.asString());
-  }
+  const auto generation = std::to_string(after.generation);
+  std::string frame = "id: " + generation + "\nevent: changes\ndata: {";
+  const bool reset = added.size() + changed.size() + removed.size() > kMaxChangeIds;
+  const auto appendIds = [&](const char* name, std::vector<std::string_view>& ids) {
+    std::sort(ids.begin(), ids.end());
+    frame += '"';
+    frame += name;
+    frame += "\":[";
+    for (size_t i = 0; i < ids.size(); ++i) {
+      if (i > 0) {
+        frame.push_back(',');
+      }
+      AppendJsonString(frame, ids[i]);
+    }
+    frame += "],";
+  };
+  if (!reset) {
+    appendIds("added", added);
+    appendIds("changed", changed);
+  }
+  frame += "\"generation\":" + generation +
+           ",\"previous\":" + std::to_string(before.generation) + ",\"product\":";
+  AppendJsonString(frame, product);
+  if (!reset) {
+    frame.push_back(',');
+    appendIds("removed", removed);
+    frame.pop_back();
+  } else {
+    frame += ",\"reset\":true";
+  }
+  frame += "}\n\n";
+  return frame;
+}
 
-  return response;
+std::string BacklogWebviewService::RenderMetrics() const {
+  std::string out;
+  metrics->Render(out);
+  out += "# HELP kano_webview_event_subscribers Open /api/events streams.\n"
+         "# TYPE kano_webview_event_subscribers gauge\n"
+         "kano_webview_event_subscribers ";
+  out += std::to_string(changeFeed->SubscriberCount());
+  out.push_back('\n');
+  return out;
 }
 
-Json::Value BacklogWebviewService::BuildKanban(const std::string& product,
-                                               bool forceRefresh) {
-  Json::Value response(Json::objectValue);
-  response["lanes"] = Json::objectValue;
-  response["lanes"]["Backlog"] = Json::arrayValue;
-  response["lanes"]["Doing"] = Json::arrayValue;
-  response["lanes"]["Blocked"] = Json::arrayValue;
-  response["lanes"]["Review"] = Json::arrayValue;
-  response["lanes"]["Done"] = Json::arrayValue;
-  response["warnings"] = Json::arrayValue;
+void BacklogWebviewService::ObserveRequest(const std::string_view route,
+                                           const std::chrono::nanoseconds elapsed,
+                                           const int status) {
+  auto& routeMetrics = metrics->Route(route);
+  routeMetrics.latency.Observe(elapsed);
+  const auto statusClass = std::clamp(status / 100, 1, 5) - 1;
+  routeMetrics.responses[static_cast<size_t>(statusClass)].fetch_add(1,
+                                                                     std::memory_order_relaxed);
+}
 
-  auto itemsResponse = ListItems(product, forceRefresh);
-  if (itemsResponse.isMember("error")) {
-    response["error"] = itemsResponse["error"];
+Json::Value BacklogWebviewService::Refresh(const std::string& product) {
+  Json::Value response(Json::objectValue);
+  if (!product.empty() && !IsValidProductName(product)) {
+    response["error"] = "Invalid product name";
     return response;
   }
-
-  for (const auto& item : itemsResponse["items"]) {
-    const auto state = item["state"].asString();
-    std::string lane = "Backlog";
-    if (state == "InProgress") {
-      lane = "Doing";
-    } else if (state == "Blocked" || text::ToLower(state) == "blocked") {
-      lane = "Blocked";
-    } else if (state == "Review" || text::ToLower(state) == "review") {
-      lane = "Review";
-    } else if (state == "Done" || text::ToLower(state) == "done" ||
-               text::ToLower(state) == "closed") {
-      lane = "Done";
-    } else if (text::ToLower(state) == "inprogress" ||
-               text::ToLower(state) == "active") {
-      lane = "Doing";
+  // States are dropped with their loadMutex held: a load still running on
+  // one finishes first, and later ones see retired and move on to the
+  // replacement. An old and a new loader of a product thus never consume
+  // the watch key they share at the same time, and no dropped loader saves
+  // an index after it is deleted. Products are locked before shared states,
+  // the order MergeSharedSources takes them in.
+  const auto collect = [&] {
+    std::vector<std::shared_ptr<ProductState>> states;
+    std::vector<std::shared_ptr<ProductState>> shared;
+    if (!product.empty()) {
+      if (const auto it = productStates.find(product); it != productStates.end()) {
+        states.push_back(it->second);
+      }
+      return states;
     }
+    const auto add = [&](const auto& products, const std::shared_ptr<ProductState>& workspace) {
+      for (const auto& [name, state] : products) {
+        states.push_back(state);
+      }
+      if (workspace) {
+        shared.push_back(workspace);
+      }
+    };
+    add(productStates, sharedState);
+    for (const auto& workspace : parkedWorkspaces) {
+      add(workspace.productStates, workspace.sharedState);
+    }
+    states.insert(states.end(), shared.begin(), shared.end());
+    return states;
+  };
 
-    response["lanes"][lane].append(item);
-  }
-
-  for (const auto& warning : itemsResponse["warnings"]) {
-    response["warnings"].append(warning.asString());
+  // A refresh reparses every source, so the on-disk indexes go too: a load
+  // would otherwise resume from them, trusting the same stats. Only the
+  // bookkeeping happens under stateMutex; see DiscardIndexes for the files.
+  // Declared ahead of the locks, which must be released first.
+  std::vector<std::shared_ptr<ProductState>> dropped;
+  std::vector<std::unique_lock<std::mutex>> loadLocks;
+  std::vector<std::filesystem::path> indexPaths;
+  std::vector<std::string> parkedKeys;
+  for (;;) {
+    loadLocks.clear();
+    {
+      std::shared_lock lock(stateMutex);
+      dropped = collect();
+    }
+    for (const auto& state : dropped) {
+      loadLocks.emplace_back(state->loadMutex);
+    }
+    std::unique_lock lock(stateMutex);
+    if (collect() != dropped) {
+      // A state was added (or swapped in) meanwhile; it has to be locked too.
+      continue;
+    }
+    for (const auto& state : dropped) {
+      state->retired.store(true, std::memory_order_release);
+    }
+    if (product.empty()) {
+      productStates.clear();
+      sharedState.reset();
+      indexPaths.push_back(IndexDirectory(productsRoot.parent_path()));
+      for (const auto& workspace : parkedWorkspaces) {
+        indexPaths.push_back(IndexDirectory(workspace.productsRoot.parent_path()));
+        parkedKeys.push_back(workspace.sharedState->watchKey);
+        for (const auto& [name, state] : workspace.productStates) {
+          parkedKeys.push_back(state->watchKey);
+        }
+      }
+      parkedWorkspaces.clear();
+    } else {
+      productStates.erase(product);
+      indexPaths.push_back(ProductIndexPath(productsRoot.parent_path(), product));
+    }
+    indexRemovals.fetch_add(1, std::memory_order_acq_rel);
+    break;
   }
+  loadLocks.clear();
+  DiscardIndexes(indexPaths);
+  watcher->Forget(parkedKeys);
+  response["refreshed"] = product.empty() ? "all" : product;
   return response;
 }
 
-Json::Value BacklogWebviewService::Refresh(const std::string& product) {
-  Json::Value response(Json::objectValue);
-  if (product.empty()) {
-    cacheByProduct.clear();
-    response["refreshed"] = "all";
-    return response;
+void BacklogWebviewService::DiscardIndexes(const std::vector<std::filesystem::path>& paths) {
+  std::error_code ignored;
+  for (const auto& path : paths) {
+    std::filesystem::remove_all(path, ignored);
   }
-  if (!IsValidProductName(product)) {
-    response["error"] = "Invalid product name";
-    return response;
-  }
-  cacheByProduct.erase(product);
-  response["refreshed"] = product;
-  return response;
+  indexRemovals.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 Json::Value BacklogWebviewService::GetWorkspaceInfo() const {
   Json::Value response(Json::objectValue);
+  std::shared_lock lock(stateMutex);
   response["products_root"] = productsRoot.generic_string();
   response["workspace_root"] = productsRoot.parent_path().generic_string();
+  response["watch_backend"] = watcher->BackendName();
+  response["load_threads"] = static_cast<Json::UInt64>(loadPool->Size());
+  response["io_threads"] = static_cast<Json::UInt64>(loadExecutor->Size());
+  response["io_queue"] = static_cast<Json::UInt64>(loadExecutor->Pending());
+  response["content_mode"] = options.lazyContent ? "lazy" : "eager";
+  response["index_cache"] = options.persistentIndex;
+  if (!pendingProductsRoot.empty()) {
+    response["pending_products_root"] = pendingProductsRoot.generic_string();
+  }
+  auto& cache = response["workspace_cache"];
+  cache["budget_bytes"] = static_cast<Json::UInt64>(options.workspaceCacheBytes);
+  size_t totalBytes = 0;
+  for (const auto& [name, state] : productStates) {
+    totalBytes += SnapshotBytes(*state);
+  }
+  auto& parked = cache["parked"] = Json::arrayValue;
+  for (const auto& workspace : parkedWorkspaces) {
+    size_t workspaceBytes = 0;
+    for (const auto& [name, state] : workspace.productStates) {
+      workspaceBytes += SnapshotBytes(*state);
+    }
+    totalBytes += workspaceBytes;
+    Json::Value entry(Json::objectValue);
+    entry["products_root"] = workspace.productsRoot.generic_string();
+    entry["products"] = static_cast<Json::UInt64>(workspace.productStates.size());
+    entry["bytes"] = static_cast<Json::UInt64>(workspaceBytes);
+    parked.append(std::move(entry));
+  }
+  cache["bytes"] = static_cast<Json::UInt64>(totalBytes);
   return response;
 }
 
-Json::Value BacklogWebviewService::SwitchWorkspace(const std::string& inputPath) {
+void BacklogWebviewService::SwitchWorkspace(const std::string& inputPath, SwitchDone done) {
   Json::Value response(Json::objectValue);
   const auto trimmed = Trim(inputPath);
   if (trimmed.empty()) {
     response["error"] = "Missing workspace path";
-    return response;
+    done(std::move(response));
+    return;
   }
 
-  std::error_code ec;
   std::filesystem::path requested(trimmed);
   auto resolved = ResolveProductsPathFromInput(requested);
   if (resolved.empty()) {
     response["error"] =
         "Path does not contain a backlog products directory (expected products/ or _kano/backlog/products/)";
-    return response;
+    done(std::move(response));
+    return;
+  }
+
+  resolved = CanonicalRoot(std::move(resolved));
+  auto products = ProductNames(resolved);
+  std::uint64_t serial = 0;
+  {
+    std::unique_lock lock(stateMutex);
+    const auto parkedIt =
+        std::find_if(parkedWorkspaces.begin(), parkedWorkspaces.end(),
+                     [&](const ParkedWorkspace& workspace) {
+                       return workspace.productsRoot == resolved;
+                     });
+    if (resolved == productsRoot || parkedIt != parkedWorkspaces.end()) {
+      // Already loaded: swap now, superseding any switch still warming.
+      ++switchSerial;
+      pendingProductsRoot.clear();
+      std::vector<std::string> evicted;
+      if (parkedIt != parkedWorkspaces.end()) {
+        auto next = std::move(*parkedIt);
+        parkedWorkspaces.erase(parkedIt);
+        evicted = ReplaceWorkspace(std::move(next));
+      }
+      response["products_root"] = productsRoot.generic_string();
+      response["workspace_root"] = productsRoot.parent_path().generic_string();
+      response["switched"] = true;
+      response["products"] = static_cast<Json::UInt64>(productStates.size());
+      lock.unlock();
+      watcher->Forget(evicted);
+      done(std::move(response));
+      return;
+    }
+    // Names used in the current workspace go first, latest use first; the
+    // rest keep ProductNames' order.
+    std::unordered_map<std::string_view, std::int64_t> lastUsed;
+    for (const auto& [product, state] : productStates) {
+      lastUsed.emplace(product, state->lastUsed.load(std::memory_order_relaxed));
+    }
+    std::stable_sort(products.begin(), products.end(),
+                     [&](const std::string& left, const std::string& right) {
+                       const auto leftIt = lastUsed.find(left);
+                       const auto rightIt = lastUsed.find(right);
+                       const auto leftUse = leftIt == lastUsed.end() ? 0 : leftIt->second;
+                       const auto rightUse = rightIt == lastUsed.end() ? 0 : rightIt->second;
+                       return leftUse > rightUse;
+                     });
+    serial = ++switchSerial;
+    pendingProductsRoot = resolved;
+  }
+  warmup->Schedule([this, resolved, products = std::move(products), serial,
+                    done = std::move(done)](const std::stop_token stop) {
+    WarmWorkspace(resolved, products, serial, stop, done);
+  });
+}
+
+Json::Value BacklogWebviewService::SwitchWorkspace(const std::string& inputPath) {
+  std::promise<Json::Value> result;
+  auto future = result.get_future();
+  SwitchWorkspace(inputPath, [&result](Json::Value response) {
+    result.set_value(std::move(response));
+  });
+  return future.get();
+}
+
+std::vector<std::string> BacklogWebviewService::ReplaceWorkspace(ParkedWorkspace next) {
+  // A parked copy of the same root shares next's watch keys; it is simply
+  // dropped.
+  parkedWorkspaces.remove_if([&](const ParkedWorkspace& workspace) {
+    return workspace.productsRoot == next.productsRoot;
+  });
+  ParkedWorkspace current{std::exchange(productsRoot, std::move(next.productsRoot)),
+                          std::exchange(productStates, std::move(next.productStates)),
+                          std::exchange(sharedState, std::move(next.sharedState))};
+  if (!current.sharedState) {
+    current.sharedState = NewSharedState(current.productsRoot);
+  }
+  parkedWorkspaces.push_front(std::move(current));
+  return TrimParkedWorkspaces();
+}
+
+std::vector<std::string> BacklogWebviewService::TrimParkedWorkspaces() {
+  std::vector<std::string> evicted;
+  const auto dropWorkspace = [&](const ParkedWorkspace& workspace) {
+    evicted.push_back(workspace.sharedState->watchKey);
+    for (const auto& [name, state] : workspace.productStates) {
+      evicted.push_back(state->watchKey);
+    }
+  };
+  while (parkedWorkspaces.size() > kMaxParkedWorkspaces ||
+         (!parkedWorkspaces.empty() && options.workspaceCacheBytes == 0)) {
+    dropWorkspace(parkedWorkspaces.back());
+    parkedWorkspaces.pop_back();
+  }
+
+  struct Candidate {
+    std::int64_t lastUsed;
+    size_t bytes;
+    ParkedWorkspace* workspace;
+    std::string product;
+  };
+  size_t totalBytes = 0;
+  for (const auto& [name, state] : productStates) {
+    totalBytes += SnapshotBytes(*state);
+  }
+  std::vector<Candidate> candidates;
+  for (auto& workspace : parkedWorkspaces) {
+    for (const auto& [name, state] : workspace.productStates) {
+      const auto bytes = SnapshotBytes(*state);
+      totalBytes += bytes;
+      candidates.push_back(
+          {state->lastUsed.load(std::memory_order_relaxed), bytes, &workspace, name});
+    }
   }
+  if (totalBytes <= options.workspaceCacheBytes) {
+    return evicted;
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& left, const Candidate& right) {
+              return left.lastUsed < right.lastUsed;
+            });
+  for (const auto& candidate : candidates) {
+    if (totalBytes <= options.workspaceCacheBytes) {
+      break;
+    }
+    auto& states = candidate.workspace->productStates;
+    const auto it = states.find(candidate.product);
+    evicted.push_back(it->second->watchKey);
+    states.erase(it);
+    totalBytes -= candidate.bytes;
+  }
+  // Without products, the shared topics and worksets are of no use.
+  parkedWorkspaces.remove_if([&](const ParkedWorkspace& workspace) {
+    if (!workspace.productStates.empty()) {
+      return false;
+    }
+    evicted.push_back(workspace.sharedState->watchKey);
+    return true;
+  });
+  return evicted;
+}
 
-  const auto canonical = std::filesystem::weakly_canonical(resolved, ec);
-  if (!ec && !canonical.empty()) {
-    resolved = canonical;
+size_t BacklogWebviewService::SnapshotBytes(const ProductState& state) {
+  const auto snapshot = state.Snapshot();
+  if (!snapshot) {
+    return 0;
   }
+  std::lock_guard lock(snapshot->views.mutex);
+  return snapshot->bytes + snapshot->views.bytes;
+}
 
-  productsRoot = resolved;
-  cacheByProduct.clear();
-  response["products_root"] = productsRoot.generic_string();
-  response["workspace_root"] = productsRoot.parent_path().generic_string();
+size_t BacklogWebviewService::EstimateBytes(const ProductCache& productCache) {
+  // Heap bytes of a string beyond its inline buffer.
+  const auto heap = [](const auto& text) {
+    return text.capacity() > 15 ? text.capacity() + 1 : 0;
+  };
+  // Records are counted in every snapshot that holds them, so the shared
+  // topics and worksets are counted once per product as well.
+  size_t bytes = sizeof(ProductCache) +
+                 productCache.allItems.capacity() * sizeof(productCache.allItems[0]);
+  for (const auto& item : productCache.allItems) {
+    if (!item) {
+      continue;
+    }
+    // 16 for the shared_ptr control block.
+    bytes += sizeof(ItemRecord) + 16 + heap(item->id) + heap(item->title) +
+             heap(item->parent) + heap(item->created) + heap(item->updated) +
+             heap(item->relativePath) + heap(item->rawContent) +
+             heap(item->contentPath.native()) + heap(item->parseError);
+  }
+  bytes += productCache.idIndexes.size() * kArenaBytesPerId;
+  for (const auto& warning : productCache.warnings) {
+    bytes += sizeof(warning) + heap(warning);
+  }
+  if (const auto& hierarchy = productCache.hierarchy) {
+    bytes += sizeof(Hierarchy) + hierarchy->slots.capacity() * sizeof(size_t) +
+             (hierarchy->parents.capacity() + hierarchy->childBegin.capacity() +
+              hierarchy->children.capacity() + hierarchy->roots.capacity()) *
+                 sizeof(std::uint32_t) +
+             hierarchy->inTree.capacity() / 8;
+    for (const auto& warning : hierarchy->warnings) {
+      bytes += sizeof(warning) + heap(warning);
+    }
+  }
+  if (const auto& kanban = productCache.kanban) {
+    bytes += sizeof(KanbanIndex) + kanban->laneBySlot.capacity() +
+             kanban->byType.capacity() * sizeof(kanban->byType[0]);
+    const auto laneBytes = [](const KanbanIndex::LaneSlots& slots) {
+      size_t total = 0;
+      for (const auto& lane : slots) {
+        total += lane.capacity() * sizeof(size_t);
+      }
+      return total;
+    };
+    bytes += laneBytes(kanban->slots);
+    for (const auto& [type, slots] : kanban->byType) {
+      bytes += laneBytes(slots);
+    }
+  }
+  return bytes;
+}
+
+void BacklogWebviewService::WarmProducts(const std::vector<std::string>& products,
+                                         const std::stop_token stop) {
+  for (const auto& product : products) {
+    if (stop.stop_requested()) {
+      return;
+    }
+    try {
+      AcquireProduct(product, false);
+    } catch (const std::exception&) {
+      // The product's own requests will hit and report the same failure.
+    }
+  }
+}
+
+void BacklogWebviewService::WarmWorkspace(const std::filesystem::path& root,
+                                          const std::vector<std::string>& products,
+                                          const std::uint64_t serial, const std::stop_token stop,
+                                          const SwitchDone& done) {
+  Json::Value response(Json::objectValue);
+  // Staged states are loaded like live ones, but nothing can reach them
+  // until the swap; the watcher arms their keys next to the current ones.
+  std::unordered_map<std::string, std::shared_ptr<ProductState>> staged;
+  std::shared_ptr<ProductState> stagedShared;
+  std::vector<std::string> stagedKeys;
+  // Keys are derived from paths, so the staged ones are only the abandoned
+  // load's own while its root is not live, parked or being loaded again.
+  // Jobs run one at a time, so none of that can change until this returns.
+  const auto rootInUse = [&] {
+    return root == productsRoot || root == pendingProductsRoot ||
+           std::any_of(parkedWorkspaces.begin(), parkedWorkspaces.end(),
+                       [&](const ParkedWorkspace& workspace) {
+                         return workspace.productsRoot == root;
+                       });
+  };
+  const auto superseded = [&] {
+    bool inUse = false;
+    {
+      std::shared_lock lock(stateMutex);
+      inUse = rootInUse();
+    }
+    if (!inUse) {
+      watcher->Forget(stagedKeys);
+    }
+    response["error"] = "Superseded by a later workspace switch";
+    done(std::move(response));
+  };
+
+  try {
+    stagedShared = NewSharedState(root);
+    stagedKeys.push_back(stagedShared->watchKey);
+    {
+      std::lock_guard loadLock(stagedShared->loadMutex);
+      LoadProduct(*stagedShared, nullptr, false, nullptr);
+    }
+    for (const auto& product : products) {
+      if (stop.stop_requested()) {
+        superseded();
+        return;
+      }
+      auto state = NewProductState(root, product);
+      stagedKeys.push_back(state->watchKey);
+      {
+        std::lock_guard loadLock(state->loadMutex);
+        LoadProduct(*state, nullptr, false, stagedShared.get());
+      }
+      staged.emplace(product, std::move(state));
+    }
+  } catch (const std::exception& error) {
+    bool inUse = false;
+    {
+      std::unique_lock lock(stateMutex);
+      if (serial == switchSerial) {
+        pendingProductsRoot.clear();
+      }
+      inUse = rootInUse();
+    }
+    if (!inUse) {
+      watcher->Forget(stagedKeys);
+    }
+    response["error"] = std::string("Workspace load failed: ") + error.what();
+    done(std::move(response));
+    return;
+  }
+
+  std::vector<std::string> evicted;
+  {
+    std::unique_lock lock(stateMutex);
+    if (serial != switchSerial) {
+      lock.unlock();
+      superseded();
+      return;
+    }
+    pendingProductsRoot.clear();
+    evicted = ReplaceWorkspace({root, std::move(staged), std::move(stagedShared)});
+    response["products_root"] = productsRoot.generic_string();
+    response["workspace_root"] = productsRoot.parent_path().generic_string();
+  }
+  watcher->Forget(evicted);
   response["switched"] = true;
-  return response;
+  response["products"] = static_cast<Json::UInt64>(products.size());
+  done(std::move(response));
+}
+
+std::string StaticAssetVersion(const std::string_view body) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (const unsigned char c : body) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  char buffer[24];
+  std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+  return buffer;
+}
+
+void RegisterStaticAsset(const std::string& path, std::string body,
+                         const std::string& contentType, const std::string& cacheControl) {
+  struct Asset {
+    std::string body;
+    // Empty when the body is too small to be worth compressing.
+    std::string gzip;
+    std::string etag;
+    std::string contentType;
+    std::string cacheControl;
+  };
+  auto asset = std::make_shared<Asset>();
+  asset->etag = '"' + StaticAssetVersion(body) + '"';
+  if (body.size() >= kMinGzipBytes) {
+    asset->gzip = GzipCompress(body);
+  }
+  asset->body = std::move(body);
+  asset->contentType = contentType;
+  asset->cacheControl = cacheControl;
+
+  drogon::app().registerHandler(
+      path,
+      [asset = std::shared_ptr<const Asset>(std::move(asset))](
+          const drogon::HttpRequestPtr& request,
+          std::function<void(const drogon::HttpResponsePtr&)>&& callback) {
+        auto response = drogon::HttpResponse::newHttpResponse();
+        if (MatchesIfNoneMatch(request->getHeader("if-none-match"), asset->etag)) {
+          response->setStatusCode(drogon::k304NotModified);
+        } else {
+          response->setContentTypeCodeAndCustomString(drogon::CT_CUSTOM, asset->contentType);
+          if (!asset->gzip.empty() && AcceptsGzip(request->getHeader("accept-encoding"))) {
+            response->setBody(asset->gzip);
+            response->addHeader("Content-Encoding", "gzip");
+          } else {
+            response->setBody(asset->body);
+          }
+        }
+        response->addHeader("ETag", asset->etag);
+        response->addHeader("Vary", "Accept-Encoding");
+        response->addHeader("Cache-Control", asset->cacheControl);
+        callback(response);
+      },
+      {drogon::Get});
 }
 
 void RegisterBacklogWebviewRoutes(
@@ -940,8 +3768,9 @@ void RegisterBacklogWebviewRoutes(
 
   app().registerHandler(
       "/healthz",
-      [metaAppender](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+      [metaAppender, &service](const HttpRequestPtr& request,
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/healthz", std::move(done));
         Json::Value body(Json::objectValue);
         body["ok"] = true;
         body["status"] = "healthy";
@@ -950,10 +3779,24 @@ void RegisterBacklogWebviewRoutes(
       },
       {Get});
 
+  app().registerHandler(
+      "/metrics",
+      [&service](const HttpRequestPtr&,
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/metrics", std::move(done));
+        auto response = HttpResponse::newHttpResponse();
+        response->setContentTypeCodeAndCustomString(
+            CT_CUSTOM, "text/plain; version=0.0.4; charset=utf-8");
+        response->setBody(service.RenderMetrics());
+        callback(response);
+      },
+      {Get});
+
   app().registerHandler(
       "/api/workspace/info",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/workspace/info", std::move(done));
         auto data = service.GetWorkspaceInfo();
         Json::Value body(Json::objectValue);
         body["ok"] = true;
@@ -966,134 +3809,239 @@ void RegisterBacklogWebviewRoutes(
   app().registerHandler(
       "/api/workspace/switch",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/workspace/switch", std::move(done));
         const auto path = request->getParameter("path");
-        auto data = service.SwitchWorkspace(path);
-        Json::Value body(Json::objectValue);
-        body["ok"] = !data.isMember("error");
-        body["data"] = data;
-        metaAppender(request, body);
-        auto response = HttpResponse::newHttpJsonResponse(body);
-        if (!body["ok"].asBool()) {
-          response->setStatusCode(k400BadRequest);
-        }
-        callback(response);
+        // Answered from the warm-up thread once the new workspace is live,
+        // so the client's next requests already see it. Resolving the path
+        // touches the disk, so that part runs on the load executor.
+        service.RunOnLoader([metaAppender, request, callback, path, &service] {
+          service.SwitchWorkspace(path, [metaAppender, request, callback](Json::Value data) {
+            Json::Value body(Json::objectValue);
+            body["ok"] = !data.isMember("error");
+            body["data"] = std::move(data);
+            metaAppender(request, body);
+            auto response = HttpResponse::newHttpJsonResponse(body);
+            if (!body["ok"].asBool()) {
+              response->setStatusCode(k400BadRequest);
+            }
+            callback(response);
+          });
+        });
       },
       {Get});
 
   app().registerHandler(
       "/api/products",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
-        Json::Value body(Json::objectValue);
-        body["ok"] = true;
-        body["data"] = service.ListProducts();
-        metaAppender(request, body);
-        callback(HttpResponse::newHttpJsonResponse(body));
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/products", std::move(done));
+        // Lists the products directory.
+        service.RunOnLoader(ReplyJob(callback, [metaAppender, request, &service] {
+          Json::Value body(Json::objectValue);
+          body["ok"] = true;
+          body["data"] = service.ListProducts();
+          metaAppender(request, body);
+          return HttpResponse::newHttpJsonResponse(body);
+        }));
       },
       {Get});
 
   app().registerHandler(
       "/api/refresh",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/refresh", std::move(done));
         const auto product = request->getParameter("product");
-        Json::Value data = service.Refresh(product);
-        Json::Value body(Json::objectValue);
-        body["ok"] = !data.isMember("error");
-        body["data"] = data;
-        metaAppender(request, body);
-        callback(HttpResponse::newHttpJsonResponse(body));
+        service.RunOnLoader(ReplyJob(callback, [metaAppender, request, product, &service] {
+          Json::Value data = service.Refresh(product);
+          Json::Value body(Json::objectValue);
+          body["ok"] = !data.isMember("error");
+          body["data"] = data;
+          metaAppender(request, body);
+          return HttpResponse::newHttpJsonResponse(body);
+        }));
+      },
+      {Get});
+
+  app().registerHandler(
+      "/api/events",
+      [metaAppender, &service](const HttpRequestPtr& request,
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/events", std::move(done));
+        const auto product = request->getParameter("product");
+        // HasProduct stats the product directory.
+        service.RunOnLoader(ReplyJob(callback, [metaAppender, request, product, &service] {
+          if (!service.HasProduct(product)) {
+            Json::Value body(Json::objectValue);
+            body["ok"] = false;
+            body["data"]["error"] = "Product not found";
+            metaAppender(request, body);
+            auto response = HttpResponse::newHttpJsonResponse(body);
+            response->setStatusCode(k404NotFound);
+            return response;
+          }
+          // The stream outlives this handler; the feed owns it through the
+          // sink and drops it (closing the connection) once a send fails.
+          auto response = HttpResponse::newAsyncStreamResponse(
+              [&service, product](ResponseStreamPtr stream) {
+                std::shared_ptr<ResponseStream> shared(std::move(stream));
+                const auto subscription = service.SubscribeChanges(
+                    product,
+                    [shared](const std::string& frame) { return shared->send(frame); });
+                if (subscription == 0) {
+                  shared->close();
+                }
+              },
+              true);
+          response->setContentTypeCodeAndCustomString(CT_CUSTOM, "text/event-stream");
+          response->addHeader("Cache-Control", "no-cache");
+          return response;
+        }));
       },
       {Get});
 
   app().registerHandler(
       "/api/items",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/items", std::move(done));
         const auto product = request->getParameter("product");
-        const auto q = request->getParameter("q");
-        auto data = service.ListItems(product);
-
-        if (data.isMember("items") && !q.empty()) {
-          Json::Value filtered(Json::arrayValue);
-          for (const auto& item : data["items"]) {
-            if (text::ContainsCaseInsensitive(item["title"].asString(), q) ||
-                text::ContainsCaseInsensitive(item["id"].asString(), q)) {
-              filtered.append(item);
+        const auto query = ItemQueryFromRequest(request);
+        // Body search reads every candidate's content.
+        const bool readsContent = query.searchBody && !query.text.empty();
+        service.RunLoaded(product, readsContent, ReplyJob(callback, [metaAppender, request,
+                                                                     product, query, &service] {
+          const auto format = request->getParameter("format");
+          if (format == "ndjson" || request->getParameter("stream") == "1") {
+            const auto streamFormat = format == "ndjson"
+                                          ? BacklogWebviewService::StreamFormat::NdJson
+                                          : BacklogWebviewService::StreamFormat::Json;
+            if (auto reader = service.StreamItems(product, query, streamFormat)) {
+              return NewStreamedResponse(request, std::move(reader), streamFormat,
+                                         metaAppender);
             }
           }
-          data["items"] = filtered;
-        }
-
-        Json::Value body(Json::objectValue);
-        body["ok"] = !data.isMember("error");
-        body["data"] = data;
-        metaAppender(request, body);
-
-        auto response = HttpResponse::newHttpJsonResponse(body);
-        if (!body["ok"].asBool()) {
-          response->setStatusCode(k400BadRequest);
-        }
-        callback(response);
+          const auto view = service.GetSerializedView(
+              product, BacklogWebviewService::View::Items, query,
+              AcceptsGzip(request->getHeader("accept-encoding")));
+          return NewViewResponse(request, view, metaAppender);
+        }));
       },
       {Get});
 
+  // Registered ahead of /api/items/{1}, which would otherwise take "batch"
+  // as an id. POST takes the same parameters form-encoded, for id lists
+  // too long for a URL.
+  app().registerHandler(
+      "/api/items/batch",
+      [metaAppender, &service](const HttpRequestPtr& request,
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/items/batch", std::move(done));
+        const auto product = request->getParameter("product");
+        const bool content = request->getParameter("content") == "1";
+        service.RunLoaded(product, content, ReplyJob(callback, [metaAppender, request, product,
+                                                                content, &service] {
+          const auto ids = SplitParameter(request->getParameter("ids"));
+          auto data = service.GetItems(product, ids, content);
+          Json::Value body(Json::objectValue);
+          body["ok"] = !data.isMember("error");
+          body["data"] = data;
+          metaAppender(request, body);
+
+          auto response = HttpResponse::newHttpJsonResponse(body);
+          if (!body["ok"].asBool()) {
+            response->setStatusCode(ids.size() > BacklogWebviewService::kMaxBatchItems
+                                        ? k400BadRequest
+                                        : k404NotFound);
+          }
+          return response;
+        }));
+      },
+      {Get, Post});
+
   app().registerHandler(
       "/api/items/{1}",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback,
+          std::function<void(const HttpResponsePtr&)>&& done,
           const std::string& itemId) {
+        const auto callback = TimedCallback(service, "/api/items/{id}", std::move(done));
         const auto product = request->getParameter("product");
-        auto data = service.GetItem(product, itemId);
-        Json::Value body(Json::objectValue);
-        body["ok"] = !data.isMember("error");
-        body["data"] = data;
-        metaAppender(request, body);
-
-        auto response = HttpResponse::newHttpJsonResponse(body);
-        if (!body["ok"].asBool()) {
-          response->setStatusCode(k404NotFound);
-        }
-        callback(response);
+        service.RunLoaded(product, true, ReplyJob(callback, [metaAppender, request, product,
+                                                             itemId, &service] {
+          auto data = service.GetItem(product, itemId);
+          Json::Value body(Json::objectValue);
+          body["ok"] = !data.isMember("error");
+          body["data"] = data;
+          metaAppender(request, body);
+
+          auto response = HttpResponse::newHttpJsonResponse(body);
+          if (!body["ok"].asBool()) {
+            response->setStatusCode(k404NotFound);
+          }
+          return response;
+        }));
       },
       {Get});
 
   app().registerHandler(
       "/api/tree",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/tree", std::move(done));
         const auto product = request->getParameter("product");
-        auto data = service.BuildTree(product);
-        Json::Value body(Json::objectValue);
-        body["ok"] = !data.isMember("error");
-        body["data"] = data;
-        metaAppender(request, body);
+        service.RunLoaded(product, false, ReplyJob(callback, [metaAppender, request, product,
+                                                              &service] {
+          const auto view =
+              service.GetSerializedView(product, BacklogWebviewService::View::Tree, {},
+                                        AcceptsGzip(request->getHeader("accept-encoding")));
+          return NewViewResponse(request, view, metaAppender);
+        }));
+      },
+      {Get});
 
-        auto response = HttpResponse::newHttpJsonResponse(body);
-        if (!body["ok"].asBool()) {
-          response->setStatusCode(k400BadRequest);
-        }
-        callback(response);
+  app().registerHandler(
+      "/api/tree/children",
+      [metaAppender, &service](const HttpRequestPtr& request,
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/tree/children", std::move(done));
+        const auto product = request->getParameter("product");
+        service.RunLoaded(product, false, ReplyJob(callback, [metaAppender, request, product,
+                                                              &service] {
+          const auto& depthParameter = request->getParameter("depth");
+          size_t depth = 1;
+          // 0 means unbounded, so a typo must not silently become it.
+          if (!depthParameter.empty() && !ParseSize(depthParameter, depth)) {
+            Json::Value body(Json::objectValue);
+            body["ok"] = false;
+            body["data"]["error"] = "Invalid depth";
+            metaAppender(request, body);
+            auto response = HttpResponse::newHttpJsonResponse(body);
+            response->setStatusCode(k400BadRequest);
+            return response;
+          }
+          const auto view = service.GetTreeChildren(
+              product, request->getParameter("id"), depth,
+              SizeParameter(request->getParameter("offset")),
+              SizeParameter(request->getParameter("limit")));
+          return NewViewResponse(request, view, metaAppender);
+        }));
       },
       {Get});
 
   app().registerHandler(
       "/api/kanban",
       [metaAppender, &service](const HttpRequestPtr& request,
-          std::function<void(const HttpResponsePtr&)>&& callback) {
+          std::function<void(const HttpResponsePtr&)>&& done) {
+        const auto callback = TimedCallback(service, "/api/kanban", std::move(done));
         const auto product = request->getParameter("product");
-        auto data = service.BuildKanban(product);
-        Json::Value body(Json::objectValue);
-        body["ok"] = !data.isMember("error");
-        body["data"] = data;
-        metaAppender(request, body);
-
-        auto response = HttpResponse::newHttpJsonResponse(body);
-        if (!body["ok"].asBool()) {
-          response->setStatusCode(k400BadRequest);
-        }
-        callback(response);
+        service.RunLoaded(product, false, ReplyJob(callback, [metaAppender, request, product,
+                                                              &service] {
+          const auto view = service.GetSerializedView(
+              product, BacklogWebviewService::View::Kanban, ItemQueryFromRequest(request),
+              AcceptsGzip(request->getHeader("accept-encoding")));
+          return NewViewResponse(request, view, metaAppender);
+        }));
       },
       {Get});
 }
@@ -0,0 +1,145 @@
+#include "KanoBacklog.ChangeFeed.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace kano::backlog::webview {
+
+namespace {
+
+// An SSE comment line; EventSource ignores it.
+const std::string kKeepAliveFrame = ": keep-alive\n\n";
+
+}  // namespace
+
+ChangeFeed::ChangeFeed(Poll pollProduct, Release releaseProduct,
+                       const std::chrono::milliseconds pollInterval,
+                       const std::chrono::milliseconds keepAliveInterval)
+    : poll(std::move(pollProduct)),
+      release(std::move(releaseProduct)),
+      interval(pollInterval),
+      keepAlive(keepAliveInterval) {}
+
+ChangeFeed::~ChangeFeed() { Stop(); }
+
+void ChangeFeed::Stop() {
+  std::thread running;
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+    running = std::move(thread);
+  }
+  wake.notify_all();
+  if (running.joinable()) {
+    running.join();
+  }
+}
+
+std::uint64_t ChangeFeed::Subscribe(std::string product, Sink sink) {
+  std::lock_guard lock(mutex);
+  const auto id = nextId++;
+  subscribers.emplace(id, std::make_shared<Subscriber>(
+                              Subscriber{std::move(product), std::move(sink)}));
+  // Greet without waiting out the rest of the interval.
+  joined = true;
+  if (!thread.joinable() && !stopping) {
+    thread = std::thread([this] { Run(); });
+  }
+  wake.notify_all();
+  return id;
+}
+
+void ChangeFeed::Unsubscribe(const std::uint64_t subscription) {
+  std::lock_guard lock(mutex);
+  subscribers.erase(subscription);
+}
+
+size_t ChangeFeed::SubscriberCount() const {
+  std::lock_guard lock(mutex);
+  return subscribers.size();
+}
+
+void ChangeFeed::Run() {
+  using Member = std::pair<std::uint64_t, std::shared_ptr<Subscriber>>;
+  auto lastKeepAlive = std::chrono::steady_clock::now();
+
+  std::unique_lock lock(mutex);
+  while (!stopping) {
+    std::map<std::string, std::vector<Member>> byProduct;
+    for (const auto& [id, subscriber] : subscribers) {
+      byProduct[subscriber->product].emplace_back(id, subscriber);
+    }
+    joined = false;
+    lock.unlock();
+
+    // Sinks and polls run unlocked, so a slow client or a product reload
+    // never blocks Subscribe.
+    const auto now = std::chrono::steady_clock::now();
+    const bool keepAliveDue = now - lastKeepAlive >= keepAlive;
+    if (keepAliveDue) {
+      lastKeepAlive = now;
+    }
+    std::vector<std::uint64_t> dead;
+    for (const auto& [product, members] : byProduct) {
+      const bool greet = std::any_of(members.begin(), members.end(),
+                                     [](const Member& member) { return !member.second->greeted; });
+      Frames frames;
+      try {
+        frames = poll(product, greet);
+      } catch (...) {
+        // A failed load is retried on the next tick; greetings wait for it.
+      }
+      polled.insert(product);
+      for (const auto& [id, subscriber] : members) {
+        const std::string* frame = nullptr;
+        if (!subscriber->greeted) {
+          if (!frames.hello.empty()) {
+            frame = &frames.hello;
+            subscriber->greeted = true;
+          }
+        } else if (!frames.changes.empty()) {
+          frame = &frames.changes;
+        } else if (keepAliveDue) {
+          frame = &kKeepAliveFrame;
+        }
+        if (frame && !subscriber->sink(*frame)) {
+          dead.push_back(id);
+        }
+      }
+    }
+
+    lock.lock();
+    for (const auto id : dead) {
+      subscribers.erase(id);
+    }
+    std::set<std::string> live;
+    for (const auto& [id, subscriber] : subscribers) {
+      live.insert(subscriber->product);
+    }
+    std::vector<std::string> idle;
+    for (auto it = polled.begin(); it != polled.end();) {
+      if (live.count(*it)) {
+        ++it;
+        continue;
+      }
+      idle.push_back(*it);
+      it = polled.erase(it);
+    }
+    if (!idle.empty()) {
+      lock.unlock();
+      for (const auto& product : idle) {
+        release(product);
+      }
+      lock.lock();
+    }
+
+    if (subscribers.empty()) {
+      wake.wait(lock, [&] { return stopping || !subscribers.empty(); });
+    } else {
+      wake.wait_for(lock, interval, [&] { return stopping || joined; });
+    }
+  }
+}
+
+}  // namespace kano::backlog::webview
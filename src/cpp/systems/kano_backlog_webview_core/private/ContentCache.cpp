@@ -0,0 +1,76 @@
+#include "KanoBacklog.ContentCache.hpp"
+
+#include "KanoBacklog.TextFile.hpp"
+
+#include <utility>
+
+namespace kano::backlog::webview {
+
+ContentCache::ContentCache(size_t capacity) : capacityBytes(capacity) {}
+
+size_t ContentCache::CapacityBytes() const {
+  return capacityBytes;
+}
+
+std::shared_ptr<const std::string> ContentCache::Read(const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return nullptr;
+  }
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return nullptr;
+  }
+
+  const auto key = path.generic_string();
+  {
+    std::lock_guard lock(mutex);
+    const auto it = byKey.find(key);
+    if (it != byKey.end()) {
+      if (it->second->mtime == mtime && it->second->size == size) {
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->text;
+      }
+      residentBytes -= it->second->text->size();
+      entries.erase(it->second);
+      byKey.erase(it);
+    }
+  }
+
+  std::string content;
+  std::string error;
+  if (!ReadTextFile(path, content, error)) {
+    return nullptr;
+  }
+  auto text = std::make_shared<const std::string>(std::move(content));
+
+  if (text->size() <= capacityBytes) {
+    Insert(Entry{key, mtime, size, text});
+  }
+  return text;
+}
+
+void ContentCache::Insert(Entry entry) {
+  std::lock_guard lock(mutex);
+  if (byKey.count(entry.key)) {
+    return;
+  }
+  residentBytes += entry.text->size();
+  entries.push_front(std::move(entry));
+  byKey[entries.front().key] = entries.begin();
+  while (residentBytes > capacityBytes && !entries.empty()) {
+    residentBytes -= entries.back().text->size();
+    byKey.erase(entries.back().key);
+    entries.pop_back();
+  }
+}
+
+void ContentCache::Clear() {
+  std::lock_guard lock(mutex);
+  entries.clear();
+  byKey.clear();
+  residentBytes = 0;
+}
+
+}  // namespace kano::backlog::webview
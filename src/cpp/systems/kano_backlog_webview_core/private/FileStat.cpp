@@ -0,0 +1,46 @@
+#include "KanoBacklog.FileStat.hpp"
+
+#include <chrono>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace kano::backlog::webview {
+
+bool StatFile(const std::filesystem::path& path, FileStat& stat) {
+#if defined(_WIN32)
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) ||
+      (data.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE)) != 0) {
+    return false;
+  }
+  // file_clock counts 100 ns ticks since 1601, as FILETIME does.
+  const auto ticks = (static_cast<std::uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) |
+                     data.ftLastWriteTime.dwLowDateTime;
+  stat.mtime = std::filesystem::file_time_type(
+      std::filesystem::file_time_type::duration(static_cast<std::int64_t>(ticks)));
+  stat.size = (static_cast<std::uintmax_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+  return true;
+#else
+  struct stat info;
+  if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+    return false;
+  }
+#if defined(__APPLE__)
+  const auto& modified = info.st_mtimespec;
+#else
+  const auto& modified = info.st_mtim;
+#endif
+  const std::chrono::sys_time<std::chrono::nanoseconds> written(
+      std::chrono::seconds(modified.tv_sec) + std::chrono::nanoseconds(modified.tv_nsec));
+  stat.mtime = std::chrono::time_point_cast<std::filesystem::file_time_type::duration>(
+      std::chrono::file_clock::from_sys(written));
+  stat.size = static_cast<std::uintmax_t>(info.st_size);
+  return true;
+#endif
+}
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,809 @@
+#include "KanoBacklog.FileWatcher.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace kano::backlog::webview {
+
+namespace {
+
+constexpr auto kPollInterval = std::chrono::milliseconds(1000);
+// Beyond this many pending paths a full reconcile is cheaper than replaying them.
+constexpr size_t kMaxPendingPaths = 4096;
+
+bool IsUnderRoot(const std::filesystem::path& path,
+                 const std::filesystem::path& root) {
+  auto pathIt = path.begin();
+  for (auto rootIt = root.begin(); rootIt != root.end(); ++rootIt, ++pathIt) {
+    if (rootIt->empty()) {
+      continue;
+    }
+    if (pathIt == path.end() || *pathIt != *rootIt) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct PollSignature {
+  std::filesystem::file_time_type latest = std::filesystem::file_time_type::min();
+  size_t fileCount = 0;
+
+  bool operator==(const PollSignature&) const = default;
+};
+
+PollSignature ComputeSignature(const std::vector<std::filesystem::path>& roots,
+                               const FileWatcher::TrackedFilter& isTracked) {
+  PollSignature signature;
+  for (const auto& root : roots) {
+    std::error_code ec;
+    if (!std::filesystem::exists(root, ec)) {
+      continue;
+    }
+    for (std::filesystem::recursive_directory_iterator it(
+             root, std::filesystem::directory_options::skip_permission_denied, ec),
+         end;
+         !ec && it != end; it.increment(ec)) {
+      if (!it->is_regular_file(ec) || !isTracked(it->path())) {
+        continue;
+      }
+      ++signature.fileCount;
+      const auto mtime = it->last_write_time(ec);
+      if (!ec && mtime > signature.latest) {
+        signature.latest = mtime;
+      }
+    }
+  }
+  return signature;
+}
+
+class NativeBackend {
+ public:
+  virtual ~NativeBackend() = default;
+  // Watches root recursively; returns false when the root cannot be watched.
+  virtual bool AddRoot(const std::filesystem::path& root) = 0;
+  // Stops watching a root previously passed to AddRoot.
+  virtual void RemoveRoot(const std::filesystem::path& root) = 0;
+  virtual void RemoveAll() = 0;
+  virtual const char* Name() const = 0;
+};
+
+std::unique_ptr<NativeBackend> CreateNativeBackend(FileWatcher::State& state);
+
+}  // namespace
+
+struct FileWatcher::State {
+  struct WatchSet {
+    std::vector<std::filesystem::path> roots;
+    bool dirty = false;
+    bool rescan = false;
+    bool polled = false;
+    std::vector<std::filesystem::path> paths;
+    PollSignature signature;
+
+    bool Covers(const std::filesystem::path& path) const {
+      return std::any_of(roots.begin(), roots.end(), [&](const std::filesystem::path& root) {
+        return IsUnderRoot(path, root);
+      });
+    }
+
+    void MarkRescan() {
+      dirty = true;
+      rescan = true;
+      paths.clear();
+    }
+  };
+
+  TrackedFilter isTracked;
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  std::map<std::string, WatchSet> sets;
+  std::set<std::filesystem::path> nativeRoots;
+  std::thread pollThread;
+  std::unique_ptr<NativeBackend> native;
+
+  // files are individual tracked files; directories invalidate whole subtrees.
+  void MarkPaths(const std::vector<std::filesystem::path>& files,
+                 const std::vector<std::filesystem::path>& directories) {
+    std::lock_guard lock(mutex);
+    for (auto& [key, set] : sets) {
+      if (set.rescan) {
+        continue;
+      }
+      const bool structural = std::any_of(
+          directories.begin(), directories.end(),
+          [&](const std::filesystem::path& directory) {
+            return set.Covers(directory) ||
+                   std::any_of(set.roots.begin(), set.roots.end(),
+                               [&](const std::filesystem::path& root) {
+                                 return IsUnderRoot(root, directory);
+                               });
+          });
+      if (structural) {
+        set.MarkRescan();
+        continue;
+      }
+      for (const auto& path : files) {
+        if (!set.Covers(path)) {
+          continue;
+        }
+        set.dirty = true;
+        if (set.paths.size() >= kMaxPendingPaths) {
+          set.MarkRescan();
+          break;
+        }
+        set.paths.push_back(path);
+      }
+    }
+  }
+
+  void MarkAll() {
+    std::lock_guard lock(mutex);
+    for (auto& [key, set] : sets) {
+      set.MarkRescan();
+    }
+  }
+
+  void EnsurePollThread() {
+    if (pollThread.joinable()) {
+      return;
+    }
+    pollThread = std::thread([this] { RunPolling(); });
+  }
+
+  void RunPolling() {
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+      wake.wait_for(lock, kPollInterval, [this] { return stopping; });
+      if (stopping) {
+        break;
+      }
+
+      std::vector<std::pair<std::string, std::vector<std::filesystem::path>>> pending;
+      for (const auto& [key, set] : sets) {
+        if (set.polled && !set.dirty) {
+          pending.emplace_back(key, set.roots);
+        }
+      }
+
+      lock.unlock();
+      std::vector<std::pair<std::string, PollSignature>> scanned;
+      scanned.reserve(pending.size());
+      for (const auto& [key, roots] : pending) {
+        scanned.emplace_back(key, ComputeSignature(roots, isTracked));
+      }
+      lock.lock();
+
+      for (const auto& [key, signature] : scanned) {
+        const auto it = sets.find(key);
+        if (it == sets.end() || !it->second.polled) {
+          continue;
+        }
+        if (!(it->second.signature == signature)) {
+          it->second.MarkRescan();
+        }
+      }
+    }
+  }
+};
+
+FileWatcher::FileWatcher(TrackedFilter isTracked) : state(std::make_unique<State>()) {
+  state->isTracked = std::move(isTracked);
+  state->native = CreateNativeBackend(*state);
+}
+
+FileWatcher::~FileWatcher() {
+  {
+    std::lock_guard lock(state->mutex);
+    state->stopping = true;
+  }
+  state->wake.notify_all();
+  if (state->pollThread.joinable()) {
+    state->pollThread.join();
+  }
+  state->native.reset();
+}
+
+void FileWatcher::Arm(const std::string& key,
+                      const std::vector<std::filesystem::path>& roots) {
+  std::vector<std::filesystem::path> normalized;
+  normalized.reserve(roots.size());
+  for (const auto& root : roots) {
+    normalized.push_back(root.lexically_normal());
+  }
+
+  std::unique_lock lock(state->mutex);
+  auto it = state->sets.find(key);
+  if (it != state->sets.end() && it->second.roots == normalized) {
+    if (it->second.polled) {
+      lock.unlock();
+      const auto signature = ComputeSignature(normalized, state->isTracked);
+      lock.lock();
+      it = state->sets.find(key);
+      if (it != state->sets.end()) {
+        it->second.signature = signature;
+      }
+    }
+    return;
+  }
+
+  State::WatchSet set;
+  set.roots = normalized;
+  // Changes pending under the old roots are kept as a rescan; their paths
+  // may not fall under the new ones.
+  if (it != state->sets.end() && it->second.dirty) {
+    set.MarkRescan();
+  }
+  for (const auto& root : normalized) {
+    if (state->nativeRoots.count(root)) {
+      continue;
+    }
+    if (state->native && state->native->AddRoot(root)) {
+      state->nativeRoots.insert(root);
+      continue;
+    }
+    set.polled = true;
+  }
+
+  // Inserted before the signature is taken, so events on the native roots
+  // added above land in this set meanwhile. It is polled only once the
+  // signature is in.
+  const bool polled = std::exchange(set.polled, false);
+  state->sets[key] = std::move(set);
+  if (polled) {
+    lock.unlock();
+    const auto signature = ComputeSignature(normalized, state->isTracked);
+    lock.lock();
+    it = state->sets.find(key);
+    if (it != state->sets.end() && it->second.roots == normalized) {
+      it->second.signature = signature;
+      it->second.polled = true;
+      state->EnsurePollThread();
+    }
+  }
+}
+
+bool FileWatcher::HasChanges(const std::string& key) const {
+  std::lock_guard lock(state->mutex);
+  const auto it = state->sets.find(key);
+  return it == state->sets.end() || it->second.dirty;
+}
+
+FileWatcher::Delta FileWatcher::ConsumeChanges(const std::string& key) {
+  Delta delta;
+  std::lock_guard lock(state->mutex);
+  const auto it = state->sets.find(key);
+  if (it == state->sets.end()) {
+    delta.dirty = true;
+    delta.rescan = true;
+    return delta;
+  }
+  auto& set = it->second;
+  delta.dirty = set.dirty;
+  delta.rescan = set.rescan;
+  delta.paths.swap(set.paths);
+  std::sort(delta.paths.begin(), delta.paths.end());
+  delta.paths.erase(std::unique(delta.paths.begin(), delta.paths.end()), delta.paths.end());
+  set.dirty = false;
+  set.rescan = false;
+  return delta;
+}
+
+void FileWatcher::Forget(const std::vector<std::string>& keys) {
+  std::lock_guard lock(state->mutex);
+  for (const auto& key : keys) {
+    state->sets.erase(key);
+  }
+  for (auto it = state->nativeRoots.begin(); it != state->nativeRoots.end();) {
+    const bool used = std::any_of(state->sets.begin(), state->sets.end(), [&](const auto& entry) {
+      const auto& roots = entry.second.roots;
+      return std::find(roots.begin(), roots.end(), *it) != roots.end();
+    });
+    if (used) {
+      ++it;
+      continue;
+    }
+    if (state->native) {
+      state->native->RemoveRoot(*it);
+    }
+    it = state->nativeRoots.erase(it);
+  }
+}
+
+void FileWatcher::Clear() {
+  std::lock_guard lock(state->mutex);
+  state->sets.clear();
+  state->nativeRoots.clear();
+  if (state->native) {
+    state->native->RemoveAll();
+  }
+}
+
+std::string FileWatcher::BackendName() const {
+  std::lock_guard lock(state->mutex);
+  const bool anyPolled = std::any_of(state->sets.begin(), state->sets.end(),
+                                     [](const auto& entry) { return entry.second.polled; });
+  if (!state->native) {
+    return "poll";
+  }
+  return anyPolled ? std::string(state->native->Name()) + "+poll" : state->native->Name();
+}
+
+namespace {
+
+#if defined(__linux__)
+
+class InotifyBackend final : public NativeBackend {
+ public:
+  explicit InotifyBackend(FileWatcher::State& owner) : owner(owner) {
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0 && pipe2(wakePipe, O_NONBLOCK | O_CLOEXEC) == 0) {
+      worker = std::thread([this] { Run(); });
+    }
+  }
+
+  ~InotifyBackend() override {
+    stopping = true;
+    if (worker.joinable()) {
+      const char byte = 1;
+      [[maybe_unused]] const auto written = write(wakePipe[1], &byte, 1);
+      worker.join();
+    }
+    for (const int end : wakePipe) {
+      if (end >= 0) {
+        close(end);
+      }
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  bool Ready() const { return worker.joinable(); }
+
+  bool AddRoot(const std::filesystem::path& root) override {
+    std::lock_guard lock(mutex);
+    std::error_code ec;
+    if (std::filesystem::is_directory(root, ec)) {
+      return AddTree(root);
+    }
+    // Root does not exist yet: watch its parent and pick the tree up on create.
+    const auto parent = root.parent_path();
+    if (parent.empty() || !std::filesystem::is_directory(parent, ec)) {
+      return false;
+    }
+    pendingRoots.insert(root);
+    parentWatches.insert(parent);
+    return AddDirectory(parent);
+  }
+
+  void RemoveRoot(const std::filesystem::path& root) override {
+    std::lock_guard lock(mutex);
+    for (auto it = pathByWd.begin(); it != pathByWd.end();) {
+      if (IsUnderRoot(it->second, root)) {
+        inotify_rm_watch(fd, it->first);
+        it = pathByWd.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    // A parent watch kept for a missing root may serve other roots; it stays.
+    pendingRoots.erase(root);
+  }
+
+  void RemoveAll() override {
+    std::lock_guard lock(mutex);
+    for (const auto& [wd, path] : pathByWd) {
+      inotify_rm_watch(fd, wd);
+    }
+    pathByWd.clear();
+    pendingRoots.clear();
+    parentWatches.clear();
+  }
+
+  const char* Name() const override { return "inotify"; }
+
+ private:
+  static constexpr uint32_t kMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE |
+                                    IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                                    IN_DELETE_SELF | IN_MOVE_SELF;
+
+  bool AddDirectory(const std::filesystem::path& directory) {
+    const int wd = inotify_add_watch(fd, directory.c_str(), kMask);
+    if (wd < 0) {
+      return false;
+    }
+    pathByWd[wd] = directory;
+    return true;
+  }
+
+  bool AddTree(const std::filesystem::path& root) {
+    if (!AddDirectory(root)) {
+      return false;
+    }
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(
+             root, std::filesystem::directory_options::skip_permission_denied, ec),
+         end;
+         !ec && it != end; it.increment(ec)) {
+      if (it->is_directory(ec) && !AddDirectory(it->path())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Run() {
+    alignas(inotify_event) char buffer[64 * 1024];
+    pollfd fds[2] = {{fd, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+    while (!stopping) {
+      if (poll(fds, 2, -1) < 0) {
+        continue;
+      }
+      if (stopping) {
+        break;
+      }
+
+      bool overflow = false;
+      std::vector<std::filesystem::path> changed;
+      std::vector<std::filesystem::path> directories;
+      {
+        std::lock_guard lock(mutex);
+        for (;;) {
+          const auto length = read(fd, buffer, sizeof(buffer));
+          if (length <= 0) {
+            break;
+          }
+          for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            HandleEvent(*event, overflow, changed, directories);
+          }
+        }
+      }
+
+      if (overflow) {
+        owner.MarkAll();
+      } else if (!changed.empty() || !directories.empty()) {
+        owner.MarkPaths(changed, directories);
+      }
+    }
+  }
+
+  void HandleEvent(const inotify_event& event, bool& overflow,
+                   std::vector<std::filesystem::path>& changed,
+                   std::vector<std::filesystem::path>& directories) {
+    if (event.mask & IN_Q_OVERFLOW) {
+      overflow = true;
+      return;
+    }
+    const auto it = pathByWd.find(event.wd);
+    if (it == pathByWd.end()) {
+      return;
+    }
+    if (event.mask & IN_IGNORED) {
+      pathByWd.erase(it);
+      return;
+    }
+
+    const auto path = event.len > 0 ? it->second / event.name : it->second;
+    const bool isDirectory = (event.mask & IN_ISDIR) != 0;
+    if (isDirectory && (event.mask & (IN_CREATE | IN_MOVED_TO))) {
+      const bool wanted = pendingRoots.erase(path) > 0 || !parentWatches.count(it->second);
+      if (wanted && !AddTree(path)) {
+        overflow = true;
+      }
+    }
+    if (isDirectory || event.len == 0) {
+      constexpr uint32_t kStructural = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                       IN_DELETE_SELF | IN_MOVE_SELF;
+      if (event.mask & kStructural) {
+        directories.push_back(path);
+      }
+      return;
+    }
+    if (owner.isTracked(path)) {
+      changed.push_back(path);
+    }
+  }
+
+  FileWatcher::State& owner;
+  int fd = -1;
+  int wakePipe[2] = {-1, -1};
+  std::atomic<bool> stopping = false;
+  std::mutex mutex;
+  std::unordered_map<int, std::filesystem::path> pathByWd;
+  std::set<std::filesystem::path> pendingRoots;
+  std::set<std::filesystem::path> parentWatches;
+  std::thread worker;
+};
+
+std::unique_ptr<NativeBackend> CreateNativeBackend(FileWatcher::State& state) {
+  auto backend = std::make_unique<InotifyBackend>(state);
+  if (!backend->Ready()) {
+    return nullptr;
+  }
+  return backend;
+}
+
+#elif defined(_WIN32)
+
+class DirectoryChangesBackend final : public NativeBackend {
+ public:
+  explicit DirectoryChangesBackend(FileWatcher::State& owner) : owner(owner) {
+    wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (wakeEvent != nullptr) {
+      worker = std::thread([this] { Run(); });
+    }
+  }
+
+  ~DirectoryChangesBackend() override {
+    stopping = true;
+    if (worker.joinable()) {
+      SetEvent(wakeEvent);
+      worker.join();
+    }
+    for (auto& watch : watches) {
+      CloseWatch(*watch);
+    }
+    if (wakeEvent != nullptr) {
+      CloseHandle(wakeEvent);
+    }
+  }
+
+  bool Ready() const { return worker.joinable(); }
+
+  bool AddRoot(const std::filesystem::path& root) override {
+    std::lock_guard lock(mutex);
+    // One wait slot is reserved for the wake event.
+    if (watches.size() + pending.size() + 1 >= MAXIMUM_WAIT_OBJECTS) {
+      return false;
+    }
+    auto watch = OpenWatch(root);
+    if (!watch) {
+      return false;
+    }
+    pending.push_back(std::move(watch));
+    SetEvent(wakeEvent);
+    return true;
+  }
+
+  // Closed by the worker, after pending watches for the root have been issued.
+  void RemoveRoot(const std::filesystem::path& root) override {
+    std::lock_guard lock(mutex);
+    removedRoots.push_back(root);
+    SetEvent(wakeEvent);
+  }
+
+  void RemoveAll() override {
+    std::lock_guard lock(mutex);
+    resetRequested = true;
+    removedRoots.clear();
+    pending.clear();
+    SetEvent(wakeEvent);
+  }
+
+  const char* Name() const override { return "ReadDirectoryChangesW"; }
+
+ private:
+  struct Watch {
+    std::filesystem::path target;
+    std::filesystem::path opened;
+    bool recursive = false;
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    OVERLAPPED overlapped{};
+    std::vector<DWORD> buffer = std::vector<DWORD>(16 * 1024);
+  };
+
+  static constexpr DWORD kFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                   FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE |
+                                   FILE_NOTIFY_CHANGE_CREATION;
+
+  static std::unique_ptr<Watch> OpenWatch(const std::filesystem::path& target) {
+    auto watch = std::make_unique<Watch>();
+    watch->target = target;
+    std::error_code ec;
+    watch->recursive = std::filesystem::is_directory(target, ec);
+    // Missing roots are observed through their parent until they appear.
+    watch->opened = watch->recursive ? target : target.parent_path();
+    if (watch->opened.empty()) {
+      return nullptr;
+    }
+    watch->directory = CreateFileW(
+        watch->opened.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (watch->directory == INVALID_HANDLE_VALUE) {
+      return nullptr;
+    }
+    watch->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (watch->overlapped.hEvent == nullptr) {
+      CloseHandle(watch->directory);
+      return nullptr;
+    }
+    return watch;
+  }
+
+  static void CloseWatch(Watch& watch) {
+    if (watch.directory != INVALID_HANDLE_VALUE) {
+      CancelIoEx(watch.directory, &watch.overlapped);
+      DWORD ignored = 0;
+      GetOverlappedResult(watch.directory, &watch.overlapped, &ignored, TRUE);
+      CloseHandle(watch.directory);
+      watch.directory = INVALID_HANDLE_VALUE;
+    }
+    if (watch.overlapped.hEvent != nullptr) {
+      CloseHandle(watch.overlapped.hEvent);
+      watch.overlapped.hEvent = nullptr;
+    }
+  }
+
+  static bool Issue(Watch& watch) {
+    ResetEvent(watch.overlapped.hEvent);
+    return ReadDirectoryChangesW(
+               watch.directory, watch.buffer.data(),
+               static_cast<DWORD>(watch.buffer.size() * sizeof(DWORD)),
+               watch.recursive ? TRUE : FALSE, kFilter, nullptr, &watch.overlapped,
+               nullptr) != FALSE;
+  }
+
+  void Run() {
+    while (!stopping) {
+      bool lostWatch = false;
+      {
+        std::lock_guard lock(mutex);
+        if (resetRequested) {
+          for (auto& watch : watches) {
+            CloseWatch(*watch);
+          }
+          watches.clear();
+          resetRequested = false;
+        }
+        for (auto& watch : pending) {
+          if (Issue(*watch)) {
+            watches.push_back(std::move(watch));
+          } else {
+            CloseWatch(*watch);
+            lostWatch = true;
+          }
+        }
+        pending.clear();
+        if (!removedRoots.empty()) {
+          std::erase_if(watches, [&](const std::unique_ptr<Watch>& watch) {
+            if (std::find(removedRoots.begin(), removedRoots.end(), watch->target) ==
+                removedRoots.end()) {
+              return false;
+            }
+            CloseWatch(*watch);
+            return true;
+          });
+          removedRoots.clear();
+        }
+      }
+      if (lostWatch) {
+        owner.MarkAll();
+      }
+
+      std::vector<HANDLE> handles = {wakeEvent};
+      for (const auto& watch : watches) {
+        handles.push_back(watch->overlapped.hEvent);
+      }
+      const DWORD signaled = WaitForMultipleObjects(
+          static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+      if (stopping) {
+        break;
+      }
+      if (signaled == WAIT_OBJECT_0 || signaled == WAIT_FAILED ||
+          signaled >= WAIT_OBJECT_0 + handles.size()) {
+        continue;
+      }
+
+      auto& watch = *watches[signaled - WAIT_OBJECT_0 - 1];
+      DWORD bytes = 0;
+      const bool completed =
+          GetOverlappedResult(watch.directory, &watch.overlapped, &bytes, FALSE) != FALSE;
+      if (!completed || bytes == 0) {
+        // Buffer overflow or handle failure: the notification list is lost.
+        owner.MarkAll();
+      } else {
+        std::vector<std::filesystem::path> directories;
+        const auto changed = CollectPaths(watch, bytes, directories);
+        owner.MarkPaths(changed, directories);
+      }
+
+      if (!watch.recursive) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(watch.target, ec)) {
+          std::lock_guard lock(mutex);
+          auto reopened = OpenWatch(watch.target);
+          if (reopened) {
+            pending.push_back(std::move(reopened));
+          }
+          CloseWatch(watch);
+          watches.erase(watches.begin() + (signaled - WAIT_OBJECT_0 - 1));
+          continue;
+        }
+      }
+      if (!Issue(watch)) {
+        std::lock_guard lock(mutex);
+        auto reopened = OpenWatch(watch.target);
+        if (reopened) {
+          pending.push_back(std::move(reopened));
+        }
+        CloseWatch(watch);
+        watches.erase(watches.begin() + (signaled - WAIT_OBJECT_0 - 1));
+      }
+    }
+  }
+
+  std::vector<std::filesystem::path> CollectPaths(
+      const Watch& watch, DWORD bytes, std::vector<std::filesystem::path>& directories) {
+    std::vector<std::filesystem::path> changed;
+    const auto* base = reinterpret_cast<const BYTE*>(watch.buffer.data());
+    for (DWORD offset = 0; offset < bytes;) {
+      const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(base + offset);
+      const std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+      auto path = (watch.opened / name).lexically_normal();
+      // Directory events carry no type flag; treat extensionless names as one.
+      if (!path.has_extension()) {
+        directories.push_back(std::move(path));
+      } else if (owner.isTracked(path)) {
+        changed.push_back(std::move(path));
+      }
+      if (info->NextEntryOffset == 0) {
+        break;
+      }
+      offset += info->NextEntryOffset;
+    }
+    return changed;
+  }
+
+  FileWatcher::State& owner;
+  HANDLE wakeEvent = nullptr;
+  std::atomic<bool> stopping = false;
+  std::mutex mutex;
+  bool resetRequested = false;
+  std::vector<std::filesystem::path> removedRoots;
+  std::vector<std::unique_ptr<Watch>> watches;
+  std::vector<std::unique_ptr<Watch>> pending;
+  std::thread worker;
+};
+
+std::unique_ptr<NativeBackend> CreateNativeBackend(FileWatcher::State& state) {
+  auto backend = std::make_unique<DirectoryChangesBackend>(state);
+  if (!backend->Ready()) {
+    return nullptr;
+  }
+  return backend;
+}
+
+#else
+
+// No native backend wired up (e.g. FSEvents on macOS); every root is polled.
+std::unique_ptr<NativeBackend> CreateNativeBackend(FileWatcher::State&) {
+  return nullptr;
+}
+
+#endif
+
+}  // namespace
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,166 @@
+#include "KanoBacklog.Gzip.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+
+#include <zlib.h>
+
+import KanoBacklogWebview.Strings;
+
+namespace kano::backlog::webview {
+
+namespace {
+
+// RFC 1952 member header: deflate, no flags or mtime, unknown OS.
+constexpr unsigned char kGzipHeader[] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+// Stored deflate blocks carry at most this many bytes.
+constexpr size_t kMaxStoredBlock = 0xffff;
+
+void AppendLittleEndian32(std::string& out, const std::uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+std::uint32_t Crc32(const std::uint32_t crc, const std::string_view data) {
+  auto result = static_cast<uLong>(crc);
+  size_t offset = 0;
+  while (offset < data.size()) {
+    const auto count = static_cast<uInt>(std::min<size_t>(data.size() - offset, 1u << 30));
+    result = crc32(result, reinterpret_cast<const Bytef*>(data.data() + offset), count);
+    offset += count;
+  }
+  return static_cast<std::uint32_t>(result);
+}
+
+// Raw deflate of data into out; flush is Z_SYNC_FLUSH (stream left open on a
+// byte boundary) or Z_FINISH.
+void Deflate(const std::string_view data, const int flush, std::string& out) {
+  z_stream stream{};
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw std::runtime_error("deflateInit2 failed");
+  }
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  size_t remaining = data.size();
+  const size_t start = out.size();
+  int status = Z_OK;
+  do {
+    const auto chunk = static_cast<uInt>(std::min<size_t>(remaining, 1u << 30));
+    stream.avail_in = chunk;
+    remaining -= chunk;
+    const int mode = remaining == 0 ? flush : Z_NO_FLUSH;
+    do {
+      const size_t used = out.size();
+      out.resize(used + std::max<size_t>(deflateBound(&stream, stream.avail_in), 4096));
+      stream.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+      stream.avail_out = static_cast<uInt>(out.size() - used);
+      status = deflate(&stream, mode);
+      out.resize(out.size() - stream.avail_out);
+    } while (stream.avail_out == 0 || (mode == Z_FINISH && status != Z_STREAM_END));
+  } while (remaining > 0);
+  deflateEnd(&stream);
+  if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+    out.resize(start);
+    throw std::runtime_error("deflate failed");
+  }
+}
+
+std::optional<double> Quality(std::string_view parameters) {
+  while (!parameters.empty()) {
+    const auto semicolon = parameters.find(';');
+    auto parameter = parameters.substr(0, semicolon);
+    parameters = semicolon == std::string_view::npos ? std::string_view()
+                                                     : parameters.substr(semicolon + 1);
+    const auto first = parameter.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+      continue;
+    }
+    parameter.remove_prefix(first);
+    if (parameter.size() >= 2 && (parameter[0] == 'q' || parameter[0] == 'Q') &&
+        parameter[1] == '=') {
+      double value = 0.0;
+      const auto* begin = parameter.data() + 2;
+      const auto* end = parameter.data() + parameter.size();
+      if (std::from_chars(begin, end, value).ec != std::errc()) {
+        return 0.0;
+      }
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+std::string GzipCompress(const std::string_view data) {
+  std::string out(reinterpret_cast<const char*>(kGzipHeader), sizeof(kGzipHeader));
+  Deflate(data, Z_FINISH, out);
+  AppendLittleEndian32(out, Crc32(0, data));
+  AppendLittleEndian32(out, static_cast<std::uint32_t>(data.size()));
+  return out;
+}
+
+GzipPrefix GzipCompressPrefix(const std::string_view head) {
+  GzipPrefix prefix;
+  prefix.bytes.assign(reinterpret_cast<const char*>(kGzipHeader), sizeof(kGzipHeader));
+  Deflate(head, Z_SYNC_FLUSH, prefix.bytes);
+  prefix.crc = Crc32(0, head);
+  prefix.size = head.size();
+  return prefix;
+}
+
+std::string GzipFinish(const GzipPrefix& prefix, const std::string_view tail) {
+  std::string out;
+  const size_t blocks = std::max<size_t>(1, (tail.size() + kMaxStoredBlock - 1) / kMaxStoredBlock);
+  out.reserve(prefix.bytes.size() + tail.size() + blocks * 5 + 8);
+  out += prefix.bytes;
+  // Stored blocks: a header byte (BFINAL on the last, BTYPE 00) then LEN and
+  // its complement; the sync flush left the stream byte aligned.
+  size_t offset = 0;
+  for (size_t block = 0; block < blocks; ++block) {
+    const auto length = std::min(tail.size() - offset, kMaxStoredBlock);
+    out.push_back(block + 1 == blocks ? 1 : 0);
+    out.push_back(static_cast<char>(length & 0xff));
+    out.push_back(static_cast<char>(length >> 8));
+    out.push_back(static_cast<char>(~length & 0xff));
+    out.push_back(static_cast<char>((~length >> 8) & 0xff));
+    out.append(tail.substr(offset, length));
+    offset += length;
+  }
+  const auto crc = crc32_combine(prefix.crc, Crc32(0, tail), static_cast<z_off_t>(tail.size()));
+  AppendLittleEndian32(out, static_cast<std::uint32_t>(crc));
+  AppendLittleEndian32(out, static_cast<std::uint32_t>(prefix.size + tail.size()));
+  return out;
+}
+
+bool AcceptsGzip(std::string_view acceptEncoding) {
+  std::optional<double> gzip;
+  std::optional<double> any;
+  while (!acceptEncoding.empty()) {
+    const auto comma = acceptEncoding.find(',');
+    auto entry = acceptEncoding.substr(0, comma);
+    acceptEncoding = comma == std::string_view::npos ? std::string_view()
+                                                     : acceptEncoding.substr(comma + 1);
+    const auto semicolon = entry.find(';');
+    auto coding = entry.substr(0, semicolon);
+    const auto first = coding.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+      continue;
+    }
+    coding = coding.substr(first, coding.find_last_not_of(" \t") - first + 1);
+    const auto quality = semicolon == std::string_view::npos
+                             ? 1.0
+                             : Quality(entry.substr(semicolon + 1)).value_or(1.0);
+    if (text::EqualsIgnoreCase(coding, "gzip") || text::EqualsIgnoreCase(coding, "x-gzip")) {
+      gzip = quality;
+    } else if (coding == "*") {
+      any = quality;
+    }
+  }
+  return gzip ? *gzip > 0.0 : any && *any > 0.0;
+}
+
+}  // namespace kano::backlog::webview
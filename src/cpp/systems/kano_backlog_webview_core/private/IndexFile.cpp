@@ -0,0 +1,140 @@
+#include "KanoBacklog.IndexFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace kano::backlog::webview {
+
+namespace {
+
+template <typename T>
+void Append(std::string& buffer, const T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  buffer.append(bytes, sizeof(T));
+}
+
+}  // namespace
+
+IndexWriter::IndexWriter(std::string_view magic, std::uint32_t version) {
+  buffer.append(magic);
+  U32(version);
+  U32(static_cast<std::uint32_t>(sizeof(void*)));
+}
+
+void IndexWriter::U8(std::uint8_t value) {
+  Append(buffer, value);
+}
+
+void IndexWriter::U32(std::uint32_t value) {
+  Append(buffer, value);
+}
+
+void IndexWriter::U64(std::uint64_t value) {
+  Append(buffer, value);
+}
+
+void IndexWriter::I64(std::int64_t value) {
+  Append(buffer, value);
+}
+
+void IndexWriter::String(std::string_view value) {
+  U32(static_cast<std::uint32_t>(value.size()));
+  buffer.append(value);
+}
+
+bool IndexWriter::Commit(const std::filesystem::path& path) const {
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  if (ec) {
+    return false;
+  }
+
+  auto temp = path;
+  temp += ".tmp";
+  {
+    std::ofstream output(temp, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+      return false;
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!output) {
+      return false;
+    }
+  }
+  std::filesystem::rename(temp, path, ec);
+  if (ec) {
+    std::filesystem::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+IndexReader::IndexReader(const std::filesystem::path& path, std::string_view magic,
+                         std::uint32_t version) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input.is_open()) {
+    return;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  if (buffer.compare(0, magic.size(), magic) != 0) {
+    return;
+  }
+  cursor = magic.size();
+  ok = true;
+
+  std::uint32_t fileVersion = 0;
+  std::uint32_t pointerSize = 0;
+  if (!U32(fileVersion) || !U32(pointerSize) || fileVersion != version ||
+      pointerSize != sizeof(void*)) {
+    ok = false;
+  }
+}
+
+bool IndexReader::Ok() const {
+  return ok;
+}
+
+bool IndexReader::AtEnd() const {
+  return ok && cursor == buffer.size();
+}
+
+bool IndexReader::Take(void* out, size_t size) {
+  if (!ok || buffer.size() - cursor < size) {
+    ok = false;
+    return false;
+  }
+  std::memcpy(out, buffer.data() + cursor, size);
+  cursor += size;
+  return true;
+}
+
+bool IndexReader::U8(std::uint8_t& value) {
+  return Take(&value, sizeof(value));
+}
+
+bool IndexReader::U32(std::uint32_t& value) {
+  return Take(&value, sizeof(value));
+}
+
+bool IndexReader::U64(std::uint64_t& value) {
+  return Take(&value, sizeof(value));
+}
+
+bool IndexReader::I64(std::int64_t& value) {
+  return Take(&value, sizeof(value));
+}
+
+bool IndexReader::String(std::string& value) {
+  std::uint32_t size = 0;
+  if (!U32(size) || buffer.size() - cursor < size) {
+    ok = false;
+    return false;
+  }
+  value.assign(buffer, cursor, size);
+  cursor += size;
+  return true;
+}
+
+}  // namespace kano::backlog::webview
@@ -0,0 +1,156 @@
+module;
+
+#include <span>
+#include <string>
+#include <string_view>
+
+export module KanoBacklogWebview.Frontmatter;
+
+namespace kano::backlog::webview::frontmatter::detail {
+
+constexpr std::string_view kWhitespace = " \t\r\n";
+
+constexpr std::string_view Trim(std::string_view value) {
+  const auto first = value.find_first_not_of(kWhitespace);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = value.find_last_not_of(kWhitespace);
+  return value.substr(first, last - first + 1);
+}
+
+constexpr std::string_view Unquote(std::string_view value) {
+  const auto trimmed = Trim(value);
+  if (trimmed.size() >= 2) {
+    const char first = trimmed.front();
+    const char last = trimmed.back();
+    if ((first == '"' && last == '"') || (first == '\'' && last == '\'')) {
+      return trimmed.substr(1, trimmed.size() - 2);
+    }
+  }
+  return trimmed;
+}
+
+constexpr bool EqualsAsciiIgnoreCase(std::string_view value, std::string_view lowered) {
+  if (value.size() != lowered.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < value.size(); ++i) {
+    char c = value[i];
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+    if (c != lowered[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// YAML-ish null spellings read as empty.
+constexpr std::string_view NormalizeNullToken(std::string_view value) {
+  const auto trimmed = Trim(value);
+  if (EqualsAsciiIgnoreCase(trimmed, "null") || EqualsAsciiIgnoreCase(trimmed, "none") ||
+      trimmed == "~") {
+    return {};
+  }
+  return value;
+}
+
+constexpr bool StartsWith(std::string_view value, std::string_view prefix) {
+  return value.substr(0, prefix.size()) == prefix;
+}
+
+}  // namespace kano::backlog::webview::frontmatter::detail
+
+export namespace kano::backlog::webview::frontmatter {
+
+// A frontmatter key the caller wants, and where its value goes.
+struct Field {
+  std::string_view key;
+  std::string* value;
+};
+
+// Single pass over the leading "---" block of content. It stops at the
+// closing marker and never reads the markdown body. Values for the requested
+// keys are unquoted, have null tokens cleared, and are written straight into
+// the targets. List items ("- x" lines under a key) are joined with commas. A
+// repeated key overwrites. Other keys are skipped without copying. On failure
+// every target is cleared and error is set.
+bool Parse(std::string_view content, std::span<const Field> fields, std::string& error) {
+  using namespace detail;
+  error.clear();
+
+  // getline semantics: '\n' separated, and a trailing newline ends the last line.
+  size_t cursor = 0;
+  const auto nextLine = [&](std::string_view& line) {
+    if (cursor >= content.size()) {
+      return false;
+    }
+    const auto end = content.find('\n', cursor);
+    const auto stop = end == std::string_view::npos ? content.size() : end;
+    line = content.substr(cursor, stop - cursor);
+    cursor = stop + 1;
+    return true;
+  };
+  const auto fail = [&](const char* message) {
+    for (const auto& field : fields) {
+      field.value->clear();
+    }
+    error = message;
+    return false;
+  };
+
+  std::string_view line;
+  if (!nextLine(line) || Trim(line) != "---") {
+    return fail("Missing frontmatter start marker");
+  }
+
+  bool haveKey = false;
+  std::string* current = nullptr;
+  while (nextLine(line)) {
+    const auto trimmed = Trim(line);
+    if (trimmed == "---") {
+      return true;
+    }
+    if (trimmed.empty()) {
+      continue;
+    }
+
+    const auto keyPos = line.find(':');
+    if (keyPos != std::string_view::npos && line[0] != ' ' && line[0] != '\t') {
+      const auto key = Trim(line.substr(0, keyPos));
+      haveKey = !key.empty();
+      current = nullptr;
+      for (const auto& field : fields) {
+        if (field.key == key) {
+          current = field.value;
+          break;
+        }
+      }
+      if (current) {
+        current->assign(NormalizeNullToken(Unquote(Trim(line.substr(keyPos + 1)))));
+      }
+      continue;
+    }
+
+    if (haveKey && (StartsWith(line, "  -") || StartsWith(line, "- "))) {
+      auto itemValue = trimmed;
+      if (StartsWith(itemValue, "- ")) {
+        itemValue = Trim(itemValue.substr(2));
+      } else if (StartsWith(itemValue, "-")) {
+        itemValue = Trim(itemValue.substr(1));
+      }
+      if (current && !itemValue.empty()) {
+        if (!current->empty()) {
+          current->push_back(',');
+        }
+        current->append(NormalizeNullToken(Unquote(itemValue)));
+      }
+    }
+  }
+
+  return fail("Missing frontmatter end marker");
+}
+
+}  // namespace kano::backlog::webview::frontmatter
@@ -1,27 +1,208 @@
 module;
 
-#include <algorithm>
-#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KANO_WEBVIEW_SSE2 1
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define KANO_WEBVIEW_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 export module KanoBacklogWebview.Strings;
 
+// ASCII-only case folding: bytes outside 'A'..'Z' (including UTF-8 sequences)
+// are compared as-is. The vector kernels fold whole blocks and fall back to
+// the scalar loop for the tail.
+namespace kano::backlog::webview::text::detail {
+
+constexpr char FoldAscii(const char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+#if defined(__AVX2__)
+constexpr size_t kBlock = 32;
+using Block = __m256i;
+
+inline Block Load(const char* data) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+}
+inline void Store(char* data, const Block value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value);
+}
+inline Block Fold(const Block value) {
+  // Signed compares: bytes >= 0x80 are negative and never fall in range.
+  const auto upper = _mm256_and_si256(_mm256_cmpgt_epi8(value, _mm256_set1_epi8('A' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), value));
+  return _mm256_or_si256(value, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+inline std::uint32_t EqualMask(const Block left, const Block right) {
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left, right)));
+}
+inline Block Broadcast(const char c) {
+  return _mm256_set1_epi8(c);
+}
+constexpr std::uint32_t kAllEqual = 0xFFFFFFFFu;
+#elif defined(KANO_WEBVIEW_SSE2)
+constexpr size_t kBlock = 16;
+using Block = __m128i;
+
+inline Block Load(const char* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+inline void Store(char* data, const Block value) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value);
+}
+inline Block Fold(const Block value) {
+  const auto upper = _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8('A' - 1)),
+                                   _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), value));
+  return _mm_or_si128(value, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+inline std::uint32_t EqualMask(const Block left, const Block right) {
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(left, right)));
+}
+inline Block Broadcast(const char c) {
+  return _mm_set1_epi8(c);
+}
+constexpr std::uint32_t kAllEqual = 0xFFFFu;
+#elif defined(KANO_WEBVIEW_NEON)
+constexpr size_t kBlock = 16;
+using Block = uint8x16_t;
+
+inline Block Load(const char* data) {
+  return vld1q_u8(reinterpret_cast<const std::uint8_t*>(data));
+}
+inline void Store(char* data, const Block value) {
+  vst1q_u8(reinterpret_cast<std::uint8_t*>(data), value);
+}
+inline Block Fold(const Block value) {
+  // Unsigned: value - 'A' <= 25 exactly for 'A'..'Z'.
+  const auto upper = vcleq_u8(vsubq_u8(value, vdupq_n_u8('A')), vdupq_n_u8('Z' - 'A'));
+  return vorrq_u8(value, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+inline std::uint32_t EqualMask(const Block left, const Block right) {
+  // One bit per byte, matching the x86 movemask layout.
+  static constexpr std::uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                             1, 2, 4, 8, 16, 32, 64, 128};
+  const auto bits = vandq_u8(vceqq_u8(left, right), vld1q_u8(kBits));
+  return static_cast<std::uint32_t>(vaddv_u8(vget_low_u8(bits))) |
+         static_cast<std::uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8;
+}
+inline Block Broadcast(const char c) {
+  return vdupq_n_u8(static_cast<std::uint8_t>(c));
+}
+constexpr std::uint32_t kAllEqual = 0xFFFFu;
+#endif
+
+#if defined(__AVX2__) || defined(KANO_WEBVIEW_SSE2) || defined(KANO_WEBVIEW_NEON)
+#define KANO_WEBVIEW_VECTOR_STRINGS 1
+#endif
+
+inline int LowestBit(const std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index = 0;
+  _BitScanForward(&index, mask);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+}  // namespace kano::backlog::webview::text::detail
+
 export namespace kano::backlog::webview::text {
 
+// Folds 'A'..'Z' in place.
+void FoldAsciiInPlace(std::string& value) {
+  size_t i = 0;
+#if defined(KANO_WEBVIEW_VECTOR_STRINGS)
+  for (; i + detail::kBlock <= value.size(); i += detail::kBlock) {
+    detail::Store(value.data() + i, detail::Fold(detail::Load(value.data() + i)));
+  }
+#endif
+  for (; i < value.size(); ++i) {
+    value[i] = detail::FoldAscii(value[i]);
+  }
+}
+
 std::string ToLower(std::string value) {
-  std::transform(value.begin(), value.end(), value.begin(),
-                 [](const unsigned char c) {
-                   return static_cast<char>(std::tolower(c));
-                 });
+  FoldAsciiInPlace(value);
   return value;
 }
 
-bool ContainsCaseInsensitive(const std::string& source,
-                             const std::string& needle) {
+bool EqualsIgnoreCase(const std::string_view left, const std::string_view right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  size_t i = 0;
+#if defined(KANO_WEBVIEW_VECTOR_STRINGS)
+  for (; i + detail::kBlock <= left.size(); i += detail::kBlock) {
+    if (detail::EqualMask(detail::Fold(detail::Load(left.data() + i)),
+                          detail::Fold(detail::Load(right.data() + i))) != detail::kAllEqual) {
+      return false;
+    }
+  }
+#endif
+  for (; i < left.size(); ++i) {
+    if (detail::FoldAscii(left[i]) != detail::FoldAscii(right[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Offset of the first case-insensitive occurrence of needle, or npos. Never
+// allocates.
+size_t FindIgnoreCase(const std::string_view haystack, const std::string_view needle) {
   if (needle.empty()) {
-    return true;
+    return 0;
+  }
+  if (needle.size() > haystack.size()) {
+    return std::string_view::npos;
   }
-  return ToLower(source).find(ToLower(needle)) != std::string::npos;
+  const char first = detail::FoldAscii(needle.front());
+  const auto rest = needle.substr(1);
+  const size_t last = haystack.size() - needle.size();
+  const auto matchesAt = [&](const size_t at) {
+    return EqualsIgnoreCase(haystack.substr(at + 1, rest.size()), rest);
+  };
+
+  size_t at = 0;
+#if defined(KANO_WEBVIEW_VECTOR_STRINGS)
+  // Screen a block of start positions on the folded first byte.
+  const auto target = detail::Broadcast(first);
+  for (; at + detail::kBlock <= last + 1; at += detail::kBlock) {
+    auto mask = detail::EqualMask(detail::Fold(detail::Load(haystack.data() + at)), target);
+    while (mask != 0) {
+      const auto candidate = at + static_cast<size_t>(detail::LowestBit(mask));
+      if (matchesAt(candidate)) {
+        return candidate;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; at <= last; ++at) {
+    if (detail::FoldAscii(haystack[at]) == first && matchesAt(at)) {
+      return at;
+    }
+  }
+  return std::string_view::npos;
+}
+
+bool ContainsCaseInsensitive(const std::string_view source, const std::string_view needle) {
+  return FindIgnoreCase(source, needle) != std::string_view::npos;
 }
 
 }  // namespace kano::backlog::webview::text
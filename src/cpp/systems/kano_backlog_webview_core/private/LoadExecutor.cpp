@@ -0,0 +1,57 @@
+#include "KanoBacklog.LoadExecutor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace kano::backlog::webview {
+
+LoadExecutor::LoadExecutor(const size_t threadCount)
+    : threadCount(std::max<size_t>(threadCount, 1)) {}
+
+LoadExecutor::~LoadExecutor() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+size_t LoadExecutor::Pending() const {
+  std::lock_guard lock(mutex);
+  return queue.size();
+}
+
+void LoadExecutor::Post(Job job) {
+  std::lock_guard lock(mutex);
+  queue.push_back(std::move(job));
+  if (idle < queue.size() && threads.size() < threadCount) {
+    threads.emplace_back([this] { Run(); });
+  }
+  wake.notify_one();
+}
+
+void LoadExecutor::Run() {
+  std::unique_lock lock(mutex);
+  while (true) {
+    ++idle;
+    wake.wait(lock, [this] { return stopping || !queue.empty(); });
+    --idle;
+    if (queue.empty()) {
+      return;
+    }
+    auto job = std::move(queue.front());
+    queue.pop_front();
+    lock.unlock();
+    try {
+      job();
+    } catch (...) {
+      // Dropped; see Post.
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace kano::backlog::webview
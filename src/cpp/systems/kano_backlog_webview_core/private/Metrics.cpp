@@ -0,0 +1,213 @@
+#include "KanoBacklog.Metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+namespace kano::backlog::webview {
+
+namespace {
+
+constexpr auto kRelaxed = std::memory_order_relaxed;
+
+void AppendLabelValue(std::string& out, const std::string_view value) {
+  for (const char c : value) {
+    if (c == '\\' || c == '"') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+
+void AppendNumber(std::string& out, const double value) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+  out += buffer;
+}
+
+void AppendHeader(std::string& out, const std::string_view name, const std::string_view type,
+                  const std::string_view help) {
+  out += "# HELP ";
+  out += name;
+  out.push_back(' ');
+  out += help;
+  out += "\n# TYPE ";
+  out += name;
+  out.push_back(' ');
+  out += type;
+  out.push_back('\n');
+}
+
+void AppendSample(std::string& out, const std::string_view name, const std::string_view labels,
+                  const std::uint64_t value) {
+  out += name;
+  if (!labels.empty()) {
+    out.push_back('{');
+    out += labels;
+    out.push_back('}');
+  }
+  out.push_back(' ');
+  out += std::to_string(value);
+  out.push_back('\n');
+}
+
+std::string Label(const std::string_view key, const std::string_view value) {
+  std::string label(key);
+  label += "=\"";
+  AppendLabelValue(label, value);
+  label.push_back('"');
+  return label;
+}
+
+}  // namespace
+
+void LatencyHistogram::Observe(const std::chrono::nanoseconds elapsed) {
+  const auto nanos = static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed.count(), 0));
+  size_t bucket = 0;
+  while (bucket < kBounds.size() && nanos > kBounds[bucket]) {
+    ++bucket;
+  }
+  buckets[bucket].fetch_add(1, kRelaxed);
+  sumNanos.fetch_add(nanos, kRelaxed);
+}
+
+void LatencyHistogram::Render(std::string& out, const std::string_view name,
+                              const std::string_view labels) const {
+  const auto prefix = labels.empty() ? std::string() : std::string(labels) + ",";
+  std::uint64_t cumulative = 0;
+  for (size_t bucket = 0; bucket <= kBounds.size(); ++bucket) {
+    cumulative += buckets[bucket].load(kRelaxed);
+    out += name;
+    out += "_bucket{";
+    out += prefix;
+    out += "le=\"";
+    if (bucket < kBounds.size()) {
+      AppendNumber(out, static_cast<double>(kBounds[bucket]) / 1e9);
+    } else {
+      out += "+Inf";
+    }
+    out += "\"} ";
+    out += std::to_string(cumulative);
+    out.push_back('\n');
+  }
+  out += name;
+  out += "_sum";
+  if (!labels.empty()) {
+    out.push_back('{');
+    out += labels;
+    out.push_back('}');
+  }
+  out.push_back(' ');
+  AppendNumber(out, static_cast<double>(sumNanos.load(kRelaxed)) / 1e9);
+  out.push_back('\n');
+  // Buckets and count are read separately; a concurrent Observe can make
+  // them disagree by one, which scrapers tolerate.
+  AppendSample(out, std::string(name) + "_count", labels, cumulative);
+}
+
+template <typename T>
+T& Metrics::Find(std::shared_mutex& mutex,
+                 std::map<std::string, std::unique_ptr<T>, std::less<>>& series,
+                 const std::string_view key) {
+  {
+    std::shared_lock lock(mutex);
+    const auto it = series.find(key);
+    if (it != series.end()) {
+      return *it->second;
+    }
+  }
+  std::unique_lock lock(mutex);
+  auto it = series.find(key);
+  if (it == series.end()) {
+    it = series.emplace(std::string(key), std::make_unique<T>()).first;
+  }
+  return *it->second;
+}
+
+ProductMetrics& Metrics::Product(const std::string_view product) {
+  return Find(productMutex, products, product);
+}
+
+RouteMetrics& Metrics::Route(const std::string_view route) {
+  return Find(routeMutex, routes, route);
+}
+
+void Metrics::Render(std::string& out) const {
+  {
+    std::shared_lock lock(routeMutex);
+    AppendHeader(out, "kano_webview_http_request_duration_seconds", "histogram",
+                 "Handler latency up to the response callback, by route pattern.");
+    for (const auto& [route, metrics] : routes) {
+      metrics->latency.Render(out, "kano_webview_http_request_duration_seconds",
+                              Label("route", route));
+    }
+    AppendHeader(out, "kano_webview_http_responses_total", "counter",
+                 "Responses by route pattern and status class.");
+    for (const auto& [route, metrics] : routes) {
+      for (size_t status = 0; status < metrics->responses.size(); ++status) {
+        const auto count = metrics->responses[status].load(kRelaxed);
+        if (count > 0) {
+          AppendSample(out, "kano_webview_http_responses_total",
+                       Label("route", route) + "," +
+                           Label("code", std::to_string(status + 1) + "xx"),
+                       count);
+        }
+      }
+    }
+  }
+
+  std::shared_lock lock(productMutex);
+  const auto histogram = [&](const char* name, const char* help,
+                             LatencyHistogram ProductMetrics::*member) {
+    AppendHeader(out, name, "histogram", help);
+    for (const auto& [product, metrics] : products) {
+      ((*metrics).*member).Render(out, name, Label("product", product));
+    }
+  };
+  const auto counter = [&](const char* name, const char* type, const char* help,
+                           std::atomic<std::uint64_t> ProductMetrics::*member) {
+    AppendHeader(out, name, type, help);
+    for (const auto& [product, metrics] : products) {
+      AppendSample(out, name, Label("product", product), ((*metrics).*member).load(kRelaxed));
+    }
+  };
+  const auto hitMiss = [&](const char* name, const char* help,
+                           std::atomic<std::uint64_t> ProductMetrics::*hits,
+                           std::atomic<std::uint64_t> ProductMetrics::*misses) {
+    AppendHeader(out, name, "counter", help);
+    for (const auto& [product, metrics] : products) {
+      const auto labels = Label("product", product);
+      AppendSample(out, name, labels + ",result=\"hit\"", ((*metrics).*hits).load(kRelaxed));
+      AppendSample(out, name, labels + ",result=\"miss\"", ((*metrics).*misses).load(kRelaxed));
+    }
+  };
+
+  histogram("kano_webview_scan_duration_seconds",
+            "Time spent finding changed sources before a reload.", &ProductMetrics::scan);
+  histogram("kano_webview_load_duration_seconds",
+            "Product loads that published a new snapshot.", &ProductMetrics::load);
+  histogram("kano_webview_serialize_duration_seconds",
+            "View bodies built outside the per-snapshot memo.", &ProductMetrics::serialize);
+  counter("kano_webview_files_parsed_total", "counter", "Source files parsed by product loads.",
+          &ProductMetrics::filesParsed);
+  hitMiss("kano_webview_snapshot_requests_total",
+          "Snapshot lookups served as is (hit) or through the loader (miss).",
+          &ProductMetrics::snapshotHits, &ProductMetrics::snapshotMisses);
+  hitMiss("kano_webview_view_cache_requests_total",
+          "Serialized view lookups answered from the per-snapshot memo.",
+          &ProductMetrics::viewHits, &ProductMetrics::viewMisses);
+  counter("kano_webview_serialized_bytes_total", "counter",
+          "Bytes of view bodies built or streamed (memo hits excluded).",
+          &ProductMetrics::bytesSerialized);
+  counter("kano_webview_snapshot_items", "gauge", "Primary ids in the current snapshot.",
+          &ProductMetrics::items);
+  counter("kano_webview_snapshot_bytes", "gauge",
+          "Estimated size of the current snapshot, view memo excluded.",
+          &ProductMetrics::snapshotBytes);
+}
+
+}  // namespace kano::backlog::webview
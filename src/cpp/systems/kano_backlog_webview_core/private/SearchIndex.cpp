@@ -0,0 +1,173 @@
+#include "KanoBacklog.SearchIndex.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+import KanoBacklogWebview.Strings;
+
+namespace kano::backlog::webview {
+
+namespace {
+
+std::uint32_t Trigram(const std::string_view text, const size_t at) {
+  return static_cast<std::uint32_t>(static_cast<unsigned char>(text[at])) << 16 |
+         static_cast<std::uint32_t>(static_cast<unsigned char>(text[at + 1])) << 8 |
+         static_cast<std::uint32_t>(static_cast<unsigned char>(text[at + 2]));
+}
+
+bool IsWordChar(const char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+}  // namespace
+
+void TrigramPostings::Add(const std::uint32_t doc, const std::string_view loweredText) {
+  for (size_t at = 0; at + 3 <= loweredText.size(); ++at) {
+    auto& list = postings[Trigram(loweredText, at)];
+    if (list.empty() || list.back() != doc) {
+      list.push_back(doc);
+    }
+  }
+}
+
+void TrigramPostings::Finalize() {
+  for (auto& [trigram, list] : postings) {
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+    list.shrink_to_fit();
+  }
+}
+
+std::vector<std::uint32_t> TrigramPostings::Candidates(
+    const std::string_view loweredNeedle) const {
+  std::vector<const std::vector<std::uint32_t>*> lists;
+  for (size_t at = 0; at + 3 <= loweredNeedle.size(); ++at) {
+    const auto it = postings.find(Trigram(loweredNeedle, at));
+    if (it == postings.end()) {
+      return {};
+    }
+    lists.push_back(&it->second);
+  }
+  if (lists.empty()) {
+    return {};
+  }
+
+  // Intersect starting from the rarest trigram.
+  std::sort(lists.begin(), lists.end(),
+            [](const auto* left, const auto* right) { return left->size() < right->size(); });
+  std::vector<std::uint32_t> result = *lists.front();
+  std::vector<std::uint32_t> scratch;
+  for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+    scratch.clear();
+    std::set_intersection(result.begin(), result.end(), lists[i]->begin(), lists[i]->end(),
+                          std::back_inserter(scratch));
+    result.swap(scratch);
+  }
+  return result;
+}
+
+void SearchIndex::Add(const size_t key, const std::string_view id,
+                      const std::string_view title) {
+  const auto doc = static_cast<std::uint32_t>(keys.size());
+  keys.push_back(key);
+  ids.push_back(text::ToLower(std::string(id)));
+  titles.push_back(text::ToLower(std::string(title)));
+  postings.Add(doc, ids.back());
+  postings.Add(doc, titles.back());
+}
+
+void SearchIndex::Finalize() {
+  postings.Finalize();
+}
+
+int SearchIndex::Score(const std::uint32_t doc, const std::string_view query) const {
+  const std::string_view id = ids[doc];
+  const std::string_view title = titles[doc];
+  if (id == query) {
+    return 6;
+  }
+  if (id.starts_with(query)) {
+    return 5;
+  }
+  if (title.starts_with(query)) {
+    return 4;
+  }
+  const auto titleAt = title.find(query);
+  if (titleAt != std::string_view::npos) {
+    for (auto at = titleAt; at != std::string_view::npos; at = title.find(query, at + 1)) {
+      if (at == 0 || !IsWordChar(title[at - 1])) {
+        return 3;
+      }
+    }
+  }
+  if (id.find(query) != std::string_view::npos) {
+    return 2;
+  }
+  if (titleAt != std::string_view::npos) {
+    return 1;
+  }
+  return 0;
+}
+
+SearchIndex::Result SearchIndex::Search(const std::string_view query,
+                                       const Options& options) const {
+  const auto lowered = text::ToLower(std::string(query));
+  const auto accepted = [&](const std::uint32_t doc) {
+    return !options.accept || options.accept(keys[doc]);
+  };
+  std::vector<std::pair<int, std::uint32_t>> hits;
+
+  if (TrigramPostings::Indexable(lowered)) {
+    for (const auto doc : postings.Candidates(lowered)) {
+      if (const int score = Score(doc, lowered); score > 0 && accepted(doc)) {
+        hits.emplace_back(score, doc);
+      }
+    }
+    if (options.bodies && options.bodyContains) {
+      // Body-only matches rank last; title/id hits are already in.
+      std::vector<std::uint32_t> matched;
+      matched.reserve(hits.size());
+      for (const auto& hit : hits) {
+        matched.push_back(hit.second);
+      }
+      std::sort(matched.begin(), matched.end());
+      for (const auto doc : options.bodies->Candidates(lowered)) {
+        if (!std::binary_search(matched.begin(), matched.end(), doc) && accepted(doc) &&
+            options.bodyContains(doc, lowered)) {
+          hits.emplace_back(0, doc);
+        }
+      }
+    }
+  } else {
+    for (std::uint32_t doc = 0; doc < keys.size(); ++doc) {
+      if (const int score = Score(doc, lowered); score > 0 && accepted(doc)) {
+        hits.emplace_back(score, doc);
+      }
+    }
+  }
+
+  const auto better = [&](const std::pair<int, std::uint32_t>& left,
+                          const std::pair<int, std::uint32_t>& right) {
+    if (left.first != right.first) {
+      return left.first > right.first;
+    }
+    return ids[left.second] < ids[right.second];
+  };
+  Result result;
+  result.total = hits.size();
+  if (options.limit > 0 && options.limit < hits.size()) {
+    std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(options.limit),
+                      hits.end(), better);
+    hits.resize(options.limit);
+  } else {
+    std::sort(hits.begin(), hits.end(), better);
+  }
+
+  result.keys.reserve(hits.size());
+  for (const auto& hit : hits) {
+    result.keys.push_back(keys[hit.second]);
+  }
+  return result;
+}
+
+}  // namespace kano::backlog::webview
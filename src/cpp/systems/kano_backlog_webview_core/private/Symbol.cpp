@@ -0,0 +1,54 @@
+#include "KanoBacklog.BacklogWebviewService.hpp"
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_set>
+
+namespace kano::backlog::webview {
+
+namespace {
+
+struct SymbolHash {
+  using is_transparent = void;
+  size_t operator()(const std::string_view value) const {
+    return std::hash<std::string_view>{}(value);
+  }
+};
+
+// Node-based, so element addresses stay valid as the pool grows. Parser
+// threads intern concurrently; after warm-up nearly every call is a hit
+// under the shared lock.
+struct SymbolPool {
+  std::shared_mutex mutex;
+  std::unordered_set<std::string, SymbolHash, std::equal_to<>> strings;
+};
+
+SymbolPool& Pool() {
+  // Leaked so records destroyed during static teardown stay valid.
+  static auto* pool = new SymbolPool();
+  return *pool;
+}
+
+const std::string* Intern(const std::string_view value) {
+  auto& pool = Pool();
+  {
+    std::shared_lock lock(pool.mutex);
+    if (const auto it = pool.strings.find(value); it != pool.strings.end()) {
+      return &*it;
+    }
+  }
+  std::unique_lock lock(pool.mutex);
+  return &*pool.strings.emplace(value).first;
+}
+
+}  // namespace
+
+Symbol::Symbol() {
+  static const std::string* const empty = Intern({});
+  text = empty;
+}
+
+Symbol::Symbol(const std::string_view value) : text(Intern(value)) {}
+
+}  // namespace kano::backlog::webview
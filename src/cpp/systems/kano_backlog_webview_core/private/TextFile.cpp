@@ -0,0 +1,32 @@
+#include "KanoBacklog.TextFile.hpp"
+
+#include <fstream>
+#include <iterator>
+
+namespace kano::backlog::webview {
+
+bool ReadTextFile(const std::filesystem::path& path, std::string& content,
+                  std::string& error) {
+  content.clear();
+  error.clear();
+  std::ifstream input(path);
+  if (!input.is_open()) {
+    error = "Failed to open file";
+    return false;
+  }
+  // Sized read; text-mode newline translation can only shrink it, hence the
+  // resize to gcount().
+  input.seekg(0, std::ios::end);
+  const auto size = static_cast<std::streamoff>(input.tellg());
+  input.seekg(0, std::ios::beg);
+  if (size < 0) {
+    content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return true;
+  }
+  content.resize(static_cast<size_t>(size));
+  input.read(content.data(), size);
+  content.resize(static_cast<size_t>(input.gcount()));
+  return true;
+}
+
+}  // namespace kano::backlog::webview
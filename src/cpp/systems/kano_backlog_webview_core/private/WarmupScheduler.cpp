@@ -0,0 +1,52 @@
+#include "KanoBacklog.WarmupScheduler.hpp"
+
+#include <utility>
+
+namespace kano::backlog::webview {
+
+WarmupScheduler::~WarmupScheduler() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+    running.request_stop();
+    for (auto& entry : queue) {
+      entry.stop.request_stop();
+    }
+  }
+  wake.notify_all();
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void WarmupScheduler::Schedule(Job job) {
+  std::lock_guard lock(mutex);
+  running.request_stop();
+  for (auto& entry : queue) {
+    entry.stop.request_stop();
+  }
+  queue.push_back({std::move(job), std::stop_source()});
+  if (!thread.joinable()) {
+    thread = std::thread([this] { Run(); });
+  }
+  wake.notify_all();
+}
+
+void WarmupScheduler::Run() {
+  std::unique_lock lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return stopping || !queue.empty(); });
+    if (queue.empty()) {
+      return;
+    }
+    auto entry = std::move(queue.front());
+    queue.pop_front();
+    running = entry.stop;
+    lock.unlock();
+    entry.job(entry.stop.get_token());
+    lock.lock();
+    running = std::stop_source(std::nostopstate);
+  }
+}
+
+}  // namespace kano::backlog::webview
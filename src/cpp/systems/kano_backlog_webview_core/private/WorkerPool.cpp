@@ -0,0 +1,112 @@
+#include "KanoBacklog.WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace kano::backlog::webview {
+
+struct WorkerPool::Batch {
+  const std::function<void(size_t)>* body = nullptr;
+  size_t count = 0;
+  std::atomic<size_t> next = 0;
+  std::atomic<size_t> completed = 0;
+  std::mutex errorMutex;
+  std::exception_ptr error;
+};
+
+WorkerPool::WorkerPool(size_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  threads.reserve(threadCount - 1);
+  for (size_t i = 1; i < threadCount; ++i) {
+    threads.emplace_back([this] { RunWorker(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+size_t WorkerPool::Size() const {
+  return threads.size() + 1;
+}
+
+void WorkerPool::Drain(Batch& batch) {
+  for (;;) {
+    const auto index = batch.next.fetch_add(1);
+    if (index >= batch.count) {
+      return;
+    }
+    try {
+      (*batch.body)(index);
+    } catch (...) {
+      std::lock_guard lock(batch.errorMutex);
+      if (!batch.error) {
+        batch.error = std::current_exception();
+      }
+    }
+    batch.completed.fetch_add(1);
+  }
+}
+
+void WorkerPool::RunWorker() {
+  std::unique_lock lock(mutex);
+  for (;;) {
+    wake.wait(lock, [this] { return stopping || !batches.empty(); });
+    if (stopping) {
+      return;
+    }
+    auto batch = batches.front();
+    lock.unlock();
+    Drain(*batch);
+    lock.lock();
+    if (!batches.empty() && batches.front() == batch) {
+      batches.pop_front();
+    }
+    if (batch->completed.load() == batch->count) {
+      finished.notify_all();
+    }
+  }
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+  if (count == 0) {
+    return;
+  }
+  auto batch = std::make_shared<Batch>();
+  batch->body = &body;
+  batch->count = count;
+
+  if (!threads.empty() && count > 1) {
+    {
+      std::lock_guard lock(mutex);
+      batches.push_back(batch);
+    }
+    wake.notify_all();
+  }
+
+  Drain(*batch);
+
+  std::unique_lock lock(mutex);
+  finished.wait(lock, [&] { return batch->completed.load() == count; });
+  const auto it = std::find(batches.begin(), batches.end(), batch);
+  if (it != batches.end()) {
+    batches.erase(it);
+  }
+  lock.unlock();
+
+  if (batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
+
+}  // namespace kano::backlog::webview
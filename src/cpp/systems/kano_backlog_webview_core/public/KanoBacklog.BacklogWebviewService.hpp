@@ -1,32 +1,175 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <drogon/drogon.h>
 
 namespace kano::backlog::webview {
 
+class ChangeFeed;
+class ContentCache;
+class FileWatcher;
+struct GzipPrefix;
+class LoadExecutor;
+class Metrics;
+class SearchIndex;
+class TrigramPostings;
+class WarmupScheduler;
+class WorkerPool;
+struct ProductMetrics;
+
+struct BacklogWebviewOptions {
+  // Parser threads used when (re)loading a product; 0 uses every core.
+  size_t loadThreads = 0;
+  // Threads that run the loads and disk reads behind HTTP requests, so the
+  // event loops keep answering from current snapshots meanwhile.
+  size_t ioThreads = 4;
+  // Drop item bodies after parsing and re-read them from disk in GetItem,
+  // keeping only the frontmatter fields resident.
+  bool lazyContent = false;
+  // Budget for the LRU of recently read bodies in lazy mode; 0 disables it.
+  size_t contentCacheBytes = 8 * 1024 * 1024;
+  // Persist each loader's parsed records under <backlog>/.cache/webview/
+  // and resume from them on a cold start.
+  bool persistentIndex = false;
+  // Load every product in the background after construction, so the first
+  // request for one is usually a cache hit.
+  bool warmOnStart = true;
+  // Budget for the estimated snapshot memory of the current workspace and
+  // the ones switched away from, which are kept so switching back is
+  // instant. Their products are evicted least recently used first; the
+  // current workspace is never evicted. 0 keeps no previous workspaces.
+  size_t workspaceCacheBytes = 256 * 1024 * 1024;
+};
+
+// Filters for the Items and Kanban views. A non-empty text returns ranked
+// matches (see SearchIndex); otherwise items are listed by id.
+struct ItemQuery {
+  std::string text;
+  // Also match text of three or more characters against item bodies.
+  bool searchBody = false;
+  // Exact matches on the cached fields; each list is OR-ed and empty
+  // matches everything. States compare case-insensitively.
+  std::vector<std::string> types;
+  std::vector<std::string> states;
+  // Matches on parent id; an empty value selects items without a parent.
+  std::optional<std::string> parent;
+  // Items pages: resume after this id (an id-ordered page's next_cursor),
+  // then skip offset matches. Kanban ignores the cursor and skips offset
+  // items in each lane.
+  std::string cursor;
+  size_t offset = 0;
+  // Maximum number of items returned (per lane for Kanban); 0 is no limit.
+  size_t limit = 0;
+  // Kanban: emit only this lane's items; totals still cover every lane.
+  std::string lane;
+  // Item members to emit; empty emits all of them. id is always emitted.
+  std::vector<std::string> fields;
+  // Kanban: only the lane and per-type totals; lanes stay empty.
+  bool countsOnly = false;
+};
+
+// Handle to a string from a process-wide pool, for the small vocabularies
+// of record fields (types, states, source kinds). One pointer per field,
+// and equal handles share the text. Pooled strings live for the process.
+class Symbol {
+ public:
+  Symbol();
+  // Interns value, and pooled strings are never freed, so only text parsed
+  // from sources is made into a Symbol. Request input compares through
+  // the text overloads of operator== below, which do not intern.
+  explicit Symbol(std::string_view value);
+  explicit Symbol(const char* value) : Symbol(std::string_view(value)) {}
+  explicit Symbol(const std::string& value) : Symbol(std::string_view(value)) {}
+
+  const std::string& str() const { return *text; }
+  bool empty() const { return text->empty(); }
+
+  friend bool operator==(const Symbol left, const Symbol right) {
+    return left.text == right.text;
+  }
+  friend bool operator==(const Symbol left, const std::string_view right) {
+    return *left.text == right;
+  }
+  friend bool operator==(const Symbol left, const std::string& right) {
+    return *left.text == right;
+  }
+  friend bool operator==(const Symbol left, const char* right) { return *left.text == right; }
+
+ private:
+  const std::string* text;
+};
+
+enum class KanbanLane : std::uint8_t { Backlog, Doing, Blocked, Review, Done };
+inline constexpr size_t kKanbanLaneCount = 5;
+
+// Sort key for timestamps that do not parse as ISO 8601.
+inline constexpr std::int64_t kNoTimestamp = INT64_MIN;
+
 struct ItemRecord {
   std::string id;
-  std::string type;
-  std::string sourceKind;
+  Symbol type;
+  Symbol sourceKind;
   std::string title;
-  std::string state;
+  Symbol state;
   std::string parent;
   std::string created;
   std::string updated;
+  // Derived by FinishRecord: the timestamps in UTC milliseconds
+  // (kNoTimestamp when unparsable).
+  std::int64_t createdAt = kNoTimestamp;
+  std::int64_t updatedAt = kNoTimestamp;
   std::string relativePath;
+  // Empty when bodyOnDisk; the body is then re-read from contentPath.
   std::string rawContent;
+  std::filesystem::path contentPath;
+  // Set by lazy parses and index restores. An eager record with an empty
+  // body is not re-read.
+  bool bodyOnDisk = false;
   bool valid;
   std::string parseError;
 };
 
 class BacklogWebviewService {
  public:
-  explicit BacklogWebviewService(std::filesystem::path productsRoot);
+  enum class View { Items, Tree, Kanban };
+
+  // Compact JSON for a view's "data" member. Successful payloads are memoized
+  // on the product snapshot, so repeat requests skip building the jsoncpp tree.
+  struct SerializedView {
+    bool ok = false;
+    std::shared_ptr<const std::string> data;
+    // Strong ETag for this view of the snapshot; empty when !ok.
+    std::string etag;
+    // !ok because the requested node does not exist (404 rather than 400).
+    bool notFound = false;
+    // When gzip was requested and data is large enough: the response
+    // envelope head ({"data":<data>) compressed once per memoized body.
+    std::shared_ptr<const GzipPrefix> gzip;
+  };
+
+  explicit BacklogWebviewService(std::filesystem::path productsRoot,
+                                 BacklogWebviewOptions options = {});
+  ~BacklogWebviewService();
 
   std::filesystem::path GetProductsRoot() const;
 
@@ -34,53 +177,488 @@ class BacklogWebviewService {
   Json::Value ListItems(const std::string& product, bool forceRefresh = false);
   Json::Value GetItem(const std::string& product, const std::string& id,
                      bool forceRefresh = false);
+  // Upper bound on ids per GetItems call.
+  static constexpr size_t kMaxBatchItems = 500;
+  // Several items from one snapshot as {"items": [...], "missing": [...]},
+  // both in request order with repeats dropped. Unlike GetItem, duplicates
+  // are not listed and content is only sent with includeContent.
+  Json::Value GetItems(const std::string& product, const std::vector<std::string>& ids,
+                       bool includeContent = false, bool forceRefresh = false);
   Json::Value BuildTree(const std::string& product, bool forceRefresh = false);
   Json::Value BuildKanban(const std::string& product,
                           bool forceRefresh = false);
+  // query applies to Items and Kanban and is ignored by Tree. gzip also
+  // fills SerializedView::gzip.
+  SerializedView GetSerializedView(const std::string& product, View view,
+                                   const ItemQuery& query = {}, bool gzip = false);
+
+  // Tree nodes under id (the roots when empty), depth levels deep (0 is
+  // unbounded). Nodes carry child_count, so deeper levels can be fetched on
+  // expand. offset and limit (0 is no limit) page the first level; total
+  // counts it. Bodies are not memoized; the ETag still applies.
+  SerializedView GetTreeChildren(const std::string& product, const std::string& id,
+                                 size_t depth, size_t offset = 0, size_t limit = 0);
+
+  enum class StreamFormat { Json, NdJson };
+  // Pull callback in drogon's stream response shape: fills up to size bytes
+  // and returns 0 at the end; a null buffer releases the snapshot early.
+  using StreamReader = std::function<std::size_t(char*, std::size_t)>;
+  // Writes the Items view straight from the snapshot in bounded chunks,
+  // without a jsoncpp tree or a full-size buffer. Json yields the same bytes
+  // as GetSerializedView's data; NdJson yields one item object per line.
+  // Empty when the product cannot be served.
+  StreamReader StreamItems(const std::string& product, const ItemQuery& query,
+                           StreamFormat format);
+  // True for a valid product name with a directory under the products root.
+  bool HasProduct(const std::string& product) const;
+
+  // Push channel for Server-Sent Events. sink receives text/event-stream
+  // frames for product from a background thread: a "hello" with the current
+  // generation, then one "changes" frame per generation bump listing the
+  // added, changed and removed primary ids, and keep-alive comments in
+  // between. It is dropped once it returns false. Returns 0, without
+  // subscribing, for a product HasProduct rejects.
+  using ChangeSink = std::function<bool(const std::string& frame)>;
+  std::uint64_t SubscribeChanges(const std::string& product, ChangeSink sink);
+  void UnsubscribeChanges(std::uint64_t subscription);
+
+  // Prometheus text exposition of the loader, view and route counters and
+  // latency histograms.
+  std::string RenderMetrics() const;
+  // Records one handled request under its route pattern.
+  void ObserveRequest(std::string_view route, std::chrono::nanoseconds elapsed, int status);
+
+  // How HTTP handlers keep disk I/O off the event loops. RunLoaded runs job
+  // inline when product's snapshot is current (and, if its records may lack
+  // in-memory bodies, the job reads none), otherwise on the load executor, where the
+  // load happens; the job then finds the product loaded. RunOnLoader always
+  // queues. Jobs that reply must do it themselves, exceptions included.
+  void RunLoaded(const std::string& product, bool readsContent, std::function<void()> job);
+  void RunOnLoader(std::function<void()> job);
+
   Json::Value Refresh(const std::string& product);
   Json::Value GetWorkspaceInfo() const;
+  // Loads the products under inputPath in the background, most recently
+  // used names first, while requests keep reading the current workspace;
+  // the new root and all of its snapshots are swapped in at once when the
+  // last one is ready. A workspace still held from an earlier switch is
+  // swapped in at once. done receives the switch result: after the swap, or
+  // an error for an invalid path or a switch superseded by a later one.
+  using SwitchDone = std::function<void(Json::Value result)>;
+  void SwitchWorkspace(const std::string& inputPath, SwitchDone done);
+  // Blocks until the switch has finished or failed.
   Json::Value SwitchWorkspace(const std::string& inputPath);
 
  private:
+  enum class SourceKind { Item, Decision, Topic, Workset };
+
+  // Products own their items/ and decisions/. The workspace-level topics/
+  // and worksets/ are loaded once by a shared loader and merged by pointer
+  // into every product snapshot.
+  enum class SourceScope { Product, Workspace };
+
+  // One parseable source with the stat data used to detect changes. Topic
+  // stats fold in brief.md, which the topic parser also reads.
+  struct SourceFile {
+    std::filesystem::path path;
+    SourceKind kind;
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
+  };
+
+  struct FileRecord {
+    SourceKind kind;
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
+    size_t slot;
+  };
+
+  struct PendingRecord {
+    std::string key;
+    SourceKind kind;
+    std::filesystem::file_time_type mtime;
+    std::uintmax_t size;
+    std::shared_ptr<const ItemRecord> record;
+  };
+
+  // Filled lazily by readers of a published snapshot. Copies start empty
+  // because the payloads belong to the snapshot they were built from.
+  struct ViewMemo {
+    ViewMemo() = default;
+    ViewMemo(const ViewMemo&) {}
+    ViewMemo& operator=(const ViewMemo&) = delete;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> bodies;
+    // Compressed envelope heads, keyed like bodies and only for memoized ones.
+    std::unordered_map<std::string, std::shared_ptr<const GzipPrefix>> gzipHeads;
+    // Size of the bodies and heads above.
+    size_t bytes = 0;
+  };
+
+  // Search structures over a snapshot's primary items, built on the first
+  // query that needs them. Copies start empty, like ViewMemo.
+  struct SearchMemo {
+    SearchMemo() = default;
+    SearchMemo(const SearchMemo&) {}
+    SearchMemo& operator=(const SearchMemo&) = delete;
+
+    std::mutex mutex;
+    std::shared_ptr<const SearchIndex> titles;
+    // Numbered like titles; only trigram postings, bodies are not kept.
+    std::shared_ptr<const TrigramPostings> bodies;
+    // Primary slots in id order, for listings and cursors.
+    std::shared_ptr<const std::vector<size_t>> byId;
+  };
+
+  // Parent/child structure of a snapshot's tree-typed primary items as
+  // index arrays, built once at load. Node indices follow id order.
+  struct Hierarchy {
+    static constexpr std::uint32_t kNoNode = UINT32_MAX;
+
+    // allItems slot of each node, sorted by id.
+    std::vector<size_t> slots;
+    // Parent node, or kNoNode for roots (no parent, or parent not a node).
+    std::vector<std::uint32_t> parents;
+    // Children of node n are children[childBegin[n] .. childBegin[n + 1]).
+    std::vector<std::uint32_t> childBegin;
+    std::vector<std::uint32_t> children;
+    std::vector<std::uint32_t> roots;
+    // Nodes reachable from a root. Those on or below a parent cycle are not,
+    // so lookups miss them and walks never enter a cycle.
+    std::vector<bool> inTree;
+    // Orphan and cycle warnings, in id order.
+    std::vector<std::string> warnings;
+  };
+
+  // Lower-cased state -> lane: the built-in rules, overridden per product by
+  // _config/kanban.json. States it does not list go to Backlog.
+  using LaneMap = std::unordered_map<std::string, KanbanLane>;
+
+  // Primary items of a product snapshot by lane under its lane map, built
+  // once at load so Kanban requests only emit. Lists follow id order.
+  struct KanbanIndex {
+    using LaneSlots = std::array<std::vector<size_t>, kKanbanLaneCount>;
+    LaneSlots slots;
+    // The same split per item type, in order of type name.
+    std::vector<std::pair<Symbol, LaneSlots>> byType;
+    // Lane of each allItems slot, for filtered queries.
+    std::vector<KanbanLane> laneBySlot;
+    // Problems with the lane map file.
+    std::vector<std::string> warnings;
+  };
+
+  // Id-keyed tables of a snapshot. Lookups take std::string or string_view
+  // without building a key.
+  struct IdHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+  };
+  // Compares as views: std::string and std::pmr::string have no operator==.
+  struct IdEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view left, std::string_view right) const {
+      return left == right;
+    }
+  };
+  template <typename T>
+  using IdMap = std::pmr::unordered_map<std::pmr::string, T, IdHash, IdEqual>;
+
+  // Immutable once published; requests keep the snapshot they acquired alive
+  // while a reload builds and swaps in the next one.
   struct ProductCache {
-    std::vector<ItemRecord> allItems;
-    std::unordered_map<std::string, std::vector<size_t>> idIndexes;
-    std::unordered_map<std::string, size_t> primaryById;
+    ProductCache();
+    // Copies the id tables into a fresh arena sized for them; memos start empty.
+    ProductCache(const ProductCache& other);
+    ProductCache& operator=(const ProductCache&) = delete;
+
+    // Backs idIndexes and primaryById (nodes, keys, slot lists) and is
+    // released with the snapshot. Entries erased by the incremental merge
+    // are not reclaimed, but the next reload copies only live ones.
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+    // Slots freed by deleted files hold nullptr; only ids in primaryById are live.
+    std::vector<std::shared_ptr<const ItemRecord>> allItems;
+    IdMap<std::pmr::vector<size_t>> idIndexes;
+    IdMap<size_t> primaryById;
     std::filesystem::file_time_type latestMtime;
     std::vector<std::string> warnings;
+    // Unique per published snapshot; feeds the view ETags.
+    std::uint64_t generation = 0;
+    // Generation of the shared topics/worksets snapshot merged in.
+    std::uint64_t sharedGeneration = 0;
+    // Null for the shared workspace snapshot and empty products.
+    std::shared_ptr<const Hierarchy> hierarchy;
+    std::shared_ptr<const KanbanIndex> kanban;
+    // Some records may have no body in memory (lazy mode, or restored from
+    // the on-disk index), so reading content can touch the disk.
+    bool contentOnDisk = false;
+    // Estimated heap size of the records, id tables and indexes, set
+    // before publishing (see EstimateBytes); the memo is counted apart.
+    size_t bytes = 0;
+    mutable ViewMemo views;
+    mutable SearchMemo search;
   };
 
+  // Loader state for one product, or for the shared workspace sources
+  // (scope Workspace, empty productRoot).
+  struct ProductState {
+    SourceScope scope = SourceScope::Product;
+    std::filesystem::path productRoot;
+    std::filesystem::path backlogRoot;
+    std::string watchKey;
+    // Series in the service's Metrics; outlives the state.
+    ProductMetrics* metrics = nullptr;
+    // steady_clock ticks of the last AcquireProduct; orders warm-up after a
+    // workspace switch.
+    std::atomic<std::int64_t> lastUsed{0};
+    // Set by Refresh, under loadMutex, when it drops the state; loaders that
+    // then get the lock retry with the state that replaced it.
+    std::atomic<bool> retired{false};
+
+    std::shared_ptr<const ProductCache> Snapshot() const;
+    void Publish(std::shared_ptr<const ProductCache> next);
+
+    // Held by the single loader of this product; guards the bookkeeping below.
+    std::mutex loadMutex;
+    std::unordered_map<std::string, FileRecord> files;
+    std::vector<size_t> freeSlots;
+    std::map<std::string, std::string> warningsBySource;
+    // Read on a rescan or when the file changes; null until then.
+    std::shared_ptr<const LaneMap> laneMap;
+    std::vector<std::string> laneMapWarnings;
+
+   private:
+    mutable std::mutex snapshotMutex;
+    std::shared_ptr<const ProductCache> snapshot;
+  };
+
+  // Guards productsRoot, productStates and the switch bookkeeping; loads run
+  // outside of it.
+  mutable std::shared_mutex stateMutex;
   std::filesystem::path productsRoot;
-  std::unordered_map<std::string, ProductCache> cacheByProduct;
+  std::unordered_map<std::string, std::shared_ptr<ProductState>> productStates;
+  std::shared_ptr<ProductState> sharedState;
+  // Root being warmed by the latest SwitchWorkspace; empty when none is.
+  std::filesystem::path pendingProductsRoot;
+  // A workspace switched away from, kept with its loaders so switching back
+  // is a swap. Its watches stay armed, so stale snapshots are still caught
+  // on the next request.
+  struct ParkedWorkspace {
+    std::filesystem::path productsRoot;
+    std::unordered_map<std::string, std::shared_ptr<ProductState>> productStates;
+    std::shared_ptr<ProductState> sharedState;
+  };
+  // Most recently used first.
+  std::list<ParkedWorkspace> parkedWorkspaces;
+  // Bumped by each SwitchWorkspace; only the latest one may swap.
+  std::uint64_t switchSerial = 0;
+  BacklogWebviewOptions options;
+  std::unique_ptr<FileWatcher> watcher;
+  std::unique_ptr<WorkerPool> loadPool;
+  std::unique_ptr<ContentCache> contentCache;
+  std::unique_ptr<Metrics> metrics;
+  std::atomic<std::uint64_t> generationCounter;
+  // Refreshes still deleting index files; cold loads skip RestoreIndex until
+  // they are done.
+  std::atomic<int> indexRemovals{0};
+  // Feed thread only: the snapshot each subscribed product's clients were
+  // last told about.
+  std::unordered_map<std::string, std::shared_ptr<const ProductCache>> feedBaselines;
+  // Products with a reload queued by the feed, so a slow load is queued once.
+  std::mutex feedReloadMutex;
+  std::unordered_set<std::string> feedReloads;
+  // Its thread loads into the state above, so it is declared after it.
+  std::unique_ptr<WarmupScheduler> warmup;
+  // Its jobs use everything above, warm-ups included, plus changeFeed; the
+  // destructor drains it once the feed has stopped queueing reloads.
+  std::unique_ptr<LoadExecutor> loadExecutor;
+  // Declared last so its thread stops before the state it polls goes away.
+  std::unique_ptr<ChangeFeed> changeFeed;
 
   static std::filesystem::path ResolveProductsPathFromInput(
       const std::filesystem::path& inputPath);
 
   bool IsValidProductName(const std::string& product) const;
-  std::filesystem::path ProductRoot(const std::string& product) const;
-  std::filesystem::file_time_type ScanLatestMtime(
-      const std::filesystem::path& productRoot) const;
-  bool ShouldLoad(const std::string& product, bool forceRefresh);
-  void LoadProduct(const std::string& product, bool forceRefresh);
+  // product's published snapshot when it and the shared sources have
+  // nothing pending from the watcher, else null. Never creates loader state.
+  std::shared_ptr<const ProductCache> CurrentSnapshot(const std::string& product) const;
+  // ChangeFeed poll for product; see SubscribeChanges for the frames.
+  void PollChanges(const std::string& product, bool greet, std::string& changes,
+                   std::string& hello);
+  // Loads product on the load executor for a later poll to report; markUsed
+  // is passed to AcquireProduct.
+  void QueueFeedReload(const std::string& product, bool markUsed);
+  std::string ChangeFrame(const std::string& product, const ProductCache& before,
+                          const ProductCache& after) const;
+  std::shared_ptr<ProductState> StateFor(const std::string& product);
+  std::shared_ptr<ProductState> SharedState();
+  // Fresh loader state, not yet registered with the service.
+  std::shared_ptr<ProductState> NewProductState(const std::filesystem::path& root,
+                                                const std::string& product) const;
+  std::shared_ptr<ProductState> NewSharedState(const std::filesystem::path& root) const;
+  // Moves the current workspace to the front of parkedWorkspaces and makes
+  // next current. Then applies the budget and returns the watch keys of
+  // what was evicted, to be forgotten after stateMutex is released. Both
+  // need stateMutex held exclusively.
+  std::vector<std::string> ReplaceWorkspace(ParkedWorkspace next);
+  std::vector<std::string> TrimParkedWorkspaces();
+  // Refresh's cleanup once it has counted itself in indexRemovals and
+  // released stateMutex: deletes paths.
+  void DiscardIndexes(const std::vector<std::filesystem::path>& paths);
+  // Estimated memory of a state's current snapshot, memo included.
+  static size_t SnapshotBytes(const ProductState& state);
+  static size_t EstimateBytes(const ProductCache& productCache);
+  // Product directories (those with items/) under root, sorted by name.
+  static std::vector<std::string> ProductNames(const std::filesystem::path& root);
+  // Warm-up jobs. WarmProducts loads into the live states; WarmWorkspace
+  // loads a staged workspace and swaps it in for switch serial.
+  void WarmProducts(const std::vector<std::string>& products, std::stop_token stop);
+  void WarmWorkspace(const std::filesystem::path& root, const std::vector<std::string>& products,
+                     std::uint64_t serial, std::stop_token stop, const SwitchDone& done);
+  // Null when a load was due but Refresh had retired shared.
+  std::shared_ptr<const ProductCache> AcquireShared(ProductState& shared);
+  // markUsed false leaves lastUsed alone, for loads no request asked for.
+  std::shared_ptr<const ProductCache> AcquireProduct(const std::string& product,
+                                                     bool forceRefresh, bool markUsed = true);
+  // shared is null when loading the shared workspace sources themselves.
+  std::shared_ptr<const ProductCache> LoadProduct(
+      ProductState& state, const std::shared_ptr<const ProductCache>& previous,
+      bool forceRefresh, ProductState* shared);
+  // Returns whether any record was added, replaced or removed. scratch is
+  // the load's arena for temporaries that die with the load.
+  bool ApplySourceChanges(ProductState& state, ProductCache& productCache,
+                          const std::vector<SourceFile>& upserts,
+                          const std::vector<std::string>& removals,
+                          std::pmr::memory_resource* scratch) const;
+  static void MergeSharedSources(ProductState& state, ProductCache& productCache,
+                                 ProductState& shared, std::pmr::memory_resource* scratch);
+  static void MergeRecords(ProductState& state, ProductCache& productCache,
+                           const std::vector<std::string>& removals,
+                           std::vector<PendingRecord>& pending,
+                           std::pmr::memory_resource* scratch);
+
+  std::shared_ptr<const ProductCache> AcquireForView(const std::string& product,
+                                                     bool forceRefresh,
+                                                     Json::Value& response);
+  static Json::Value EmptyViewData(View view);
+  // Sets view.gzip for a large enough body, sharing it through the memo
+  // when view.data is the memoized body for memoKey.
+  static void AttachGzip(const ProductCache& productCache, const std::string& memoKey,
+                         SerializedView& view);
+  void FillViewData(View view, const ProductCache& productCache, const ItemQuery& query,
+                    Json::Value& response) const;
+  void FillItemsData(const ProductCache& productCache, const ItemQuery& query,
+                     Json::Value& response) const;
+  static void FillTreeData(const ProductCache& productCache, Json::Value& response);
+  static void AppendTreeData(std::string& out, const ProductCache& productCache);
+  // Writes nodes from starts as a JSON array; maxDepth 0 is unbounded.
+  static void AppendTreeNodes(std::string& out, const ProductCache& productCache,
+                              const std::vector<std::uint32_t>& starts, size_t maxDepth,
+                              bool withChildCount);
+  static std::uint32_t FindTreeNode(const ProductCache& productCache, const std::string& id);
+  static std::shared_ptr<const Hierarchy> BuildHierarchy(const ProductCache& productCache);
+  static bool IsTreeType(const std::string& type);
+  static std::filesystem::path LaneMapPath(const ProductState& state);
+  // Built-in rules plus the product's overrides; problems go to warnings.
+  static std::shared_ptr<const LaneMap> LoadLaneMap(const std::filesystem::path& path,
+                                                    std::vector<std::string>& warnings);
+  static std::shared_ptr<const KanbanIndex> BuildKanbanIndex(const ProductCache& productCache,
+                                                             const LaneMap& laneMap,
+                                                             std::vector<std::string> warnings);
+  void FillKanbanData(const ProductCache& productCache, const ItemQuery& query,
+                      Json::Value& response) const;
+
+  // Members of a listed item, for fields= projection.
+  enum ItemField : std::uint32_t {
+    kFieldCreated = 1u << 0,
+    kFieldDuplicateCount = 1u << 1,
+    kFieldParent = 1u << 2,
+    kFieldParseError = 1u << 3,
+    kFieldPath = 1u << 4,
+    kFieldSourceKind = 1u << 5,
+    kFieldState = 1u << 6,
+    kFieldTitle = 1u << 7,
+    kFieldType = 1u << 8,
+    kFieldUpdated = 1u << 9,
+    kFieldValid = 1u << 10,
+    kAllItemFields = (1u << 11) - 1,
+  };
+  static std::uint32_t FieldMask(const ItemQuery& query);
+  // Canonical form of query for memo keys and ETags.
+  static std::string ItemQueryKey(const ItemQuery& query);
+
+  // One page of matches. total counts every match; nextOffset is 0 on the last page.
+  struct ItemSelection {
+    std::vector<size_t> slots;
+    size_t total = 0;
+    size_t nextOffset = 0;
+    std::string nextCursor;
+  };
+  // paginate=false returns every match (Kanban applies its own lane limit).
+  ItemSelection SelectItems(const ProductCache& productCache, const ItemQuery& query,
+                            bool paginate) const;
+  static bool MatchesFilters(const ItemRecord& item, const ItemQuery& query);
+  // Best keep (0 = all) ranked primary slots matching query.text that pass
+  // the filters; total receives the number of matches.
+  std::vector<size_t> SearchItems(const ProductCache& productCache, const ItemQuery& query,
+                                  size_t keep, size_t& total) const;
+  static std::shared_ptr<const std::vector<size_t>> SlotsById(const ProductCache& productCache);
+  static const char* LaneName(KanbanLane lane);
+  static std::optional<KanbanLane> LaneFromName(std::string_view name);
+  // Fills the fields derived from the parsed text (timestamp keys).
+  static void FinishRecord(ItemRecord& item);
+  static Json::Value ListedItemJson(const ProductCache& productCache, size_t primaryIndex,
+                                    std::uint32_t fields = kAllItemFields);
+
+  // Cursor over one snapshot's Items view for StreamItems and the memo.
+  struct ItemStreamState;
+  std::shared_ptr<ItemStreamState> OpenItemStream(std::shared_ptr<const ProductCache> snapshot,
+                                                  const ItemQuery& query,
+                                                  StreamFormat format) const;
+  // Appends about one chunk to state.pending; false once everything is out.
+  static bool NextItemChunk(ItemStreamState& state);
+  static void AppendListedItem(std::string& out, const ProductCache& productCache,
+                               size_t primaryIndex, std::uint32_t fields);
+
+  static std::filesystem::path IndexDirectory(const std::filesystem::path& backlogRoot);
+  static std::filesystem::path ProductIndexPath(const std::filesystem::path& backlogRoot,
+                                                const std::string& product);
+  static std::filesystem::path IndexPath(const ProductState& state);
+  static void SaveIndex(const ProductState& state, const ProductCache& productCache);
+  static bool RestoreIndex(ProductState& state, ProductCache& productCache);
+
+  static std::vector<std::filesystem::path> TrackedRoots(const ProductState& state);
+  static std::vector<SourceFile> EnumerateSources(const ProductState& state);
+  static std::optional<SourceFile> ResolveChangedSource(
+      const std::filesystem::path& changedPath, const ProductState& state, bool& removed);
+  ItemRecord ParseSource(const SourceFile& source, const ProductState& state) const;
+  std::string ItemContent(const ItemRecord& item) const;
+  static bool StatSource(SourceFile& source);
+  static std::string SourceKey(const std::filesystem::path& path);
+  static void SelectPrimary(ProductCache& productCache, std::string_view id);
 
   static bool IsMarkdownItemFile(const std::filesystem::path& path);
+  static bool IsTrackedFile(const std::filesystem::path& path);
   static bool ShouldSkipPath(const std::filesystem::path& path);
   static std::string NormalizeTypeFromPath(
       const std::filesystem::path& itemPath, const std::string& declaredType);
 
+  // The parsers read the source body into content, which ParseSource either
+  // moves into rawContent or keeps as a reused buffer in lazy mode.
   static ItemRecord ParseItem(const std::filesystem::path& itemPath,
-                              const std::filesystem::path& productRoot);
+                              const std::filesystem::path& productRoot, std::string& content);
   static ItemRecord ParseDecision(const std::filesystem::path& decisionPath,
-                                  const std::filesystem::path& productRoot);
+                                  const std::filesystem::path& productRoot,
+                                  std::string& content);
   static ItemRecord ParseTopicManifest(const std::filesystem::path& topicManifestPath,
-                                       const std::filesystem::path& backlogRoot);
+                                       const std::filesystem::path& backlogRoot,
+                                       std::string& content);
   static ItemRecord ParseWorksetManifest(
       const std::filesystem::path& worksetManifestPath,
-      const std::filesystem::path& backlogRoot);
-  static std::unordered_map<std::string, std::string> ParseFrontmatterMap(
-      const std::string& content, bool& ok, std::string& error);
-  static Json::Value ParseJsonFile(const std::filesystem::path& jsonPath, bool& ok,
-                                   std::string& error);
+      const std::filesystem::path& backlogRoot, std::string& content);
+  // Leaves the file text in text.
+  static Json::Value ParseJsonFile(const std::filesystem::path& jsonPath, std::string& text,
+                                   bool& ok, std::string& error);
 
   static Json::Value ItemToJson(const ItemRecord& item, bool includeContent = false);
   static std::string ToIsoString(const std::filesystem::file_time_type& value);
@@ -91,4 +669,13 @@ void RegisterBacklogWebviewRoutes(
     const std::function<void(const drogon::HttpRequestPtr&, Json::Value&)>&
         appendCommonMeta);
 
+// 16 hex digits identifying body's content, for versioned asset URLs.
+std::string StaticAssetVersion(std::string_view body);
+
+// Serves a fixed body at path for GET. The body is gzipped once at
+// registration; responses carry a content ETag, answer a matching
+// If-None-Match with 304 and send cacheControl as Cache-Control.
+void RegisterStaticAsset(const std::string& path, std::string body,
+                         const std::string& contentType, const std::string& cacheControl);
+
 }  // namespace kano::backlog::webview